@@ -1,63 +1,63 @@
-# MIT License
-
-# Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-		
-# Permission is hereby granted, free of charge, to any person obtaining a copy
-# of this software and associated documentation files (the "Software"), to deal
-# in the Software without restriction, including without limitation the rights
-# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-# copies of the Software, and to permit persons to whom the Software is
-# furnished to do so, subject to the following conditions:
-
-# The above copyright notice and this permission notice shall be included in all
-# copies or substantial portions of the Software.
-
-# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-# SOFTWARE.
-
-
-# W
-power = {
-    "Node.F" : 6.320e-3,
-    "Node.D" : 5.463e-3,
-    "Node.M" : 48.127e-3,
-    "Node.ALU" : 2.142e-3,
-    "Node.FPU" : 4.500e-3,
-    "Node.Static" : 6.318e-3,
-    "Tile.F" : 6.320e-3,
-    "Tile.D" : 5.463e-3,
-    "Tile.M" : 22.938e-3,
-    "Tile.ALU" : 2.142e-3,
-    "Tile.FPU" : 4.500e-3,
-    "Tile.Static" : 5.974e-3,
-    "Core.F" : 6.320e-3,
-    "Core.D" : 5.463e-3,
-    "Core.M" : 8.089e-3,
-    "Core.ALU" : 2.142e-3,
-    "Core.FPU" : 2.200e-3,
-    "Core.Static" : 4.316e-3,
-    "Router.FPU" : 4.500e-3,
-    "Router.MUX" : 2.937e-3,
-    "Router.Static" : 1.601e-3,
-    "MPE.Active" : 0.042e-3,
-    "MPE.Static" : 0.013e-3,
-    "MMR.Static" : 0.005e-3,
-    "CPU" : 6.7,
-    "GPU" : 125
-}
-
-# mm^2 
-area = {
-    "Node" : 0.121,
-    "Tile" : 0.132,
-    "Core" : 0.049,
-    "Router" : 0.015,
-    "CAM" : 0.034,
-    "MPE" : 0.011,
-    "MMR" : 0.001
+# MIT License
+
+# Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+		
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# W
+power = {
+    "Node.F" : 6.320e-3,
+    "Node.D" : 5.463e-3,
+    "Node.M" : 48.127e-3,
+    "Node.ALU" : 2.142e-3,
+    "Node.FPU" : 4.500e-3,
+    "Node.Static" : 6.318e-3,
+    "Tile.F" : 6.320e-3,
+    "Tile.D" : 5.463e-3,
+    "Tile.M" : 22.938e-3,
+    "Tile.ALU" : 2.142e-3,
+    "Tile.FPU" : 4.500e-3,
+    "Tile.Static" : 5.974e-3,
+    "Core.F" : 6.320e-3,
+    "Core.D" : 5.463e-3,
+    "Core.M" : 8.089e-3,
+    "Core.ALU" : 2.142e-3,
+    "Core.FPU" : 2.200e-3,
+    "Core.Static" : 4.316e-3,
+    "Router.FPU" : 4.500e-3,
+    "Router.MUX" : 2.937e-3,
+    "Router.Static" : 1.601e-3,
+    "MPE.Active" : 0.042e-3,
+    "MPE.Static" : 0.013e-3,
+    "MMR.Static" : 0.005e-3,
+    "CPU" : 6.7,
+    "GPU" : 125
+}
+
+# mm^2 
+area = {
+    "Node" : 0.121,
+    "Tile" : 0.132,
+    "Core" : 0.049,
+    "Router" : 0.015,
+    "CAM" : 0.034,
+    "MPE" : 0.011,
+    "MMR" : 0.001
 }
\ No newline at end of file
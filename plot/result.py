@@ -0,0 +1,46 @@
+# MIT License
+
+# Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+		
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+import numpy as np
+
+def readResult(path):
+    """!
+    @brief      Read the binary results of control_node (resultFormat=binary).
+    @details    There is one record per test sample and class: uint32 sample id, uint32 class, uint64 completion
+                time (ns), uint32 number of values, then the FP32 SHAP values of the features.
+    @param[in]  path:           Path of result.bin
+    @return     sample id, class, time (ns) and SHAP values (numResult x numValue) as numpy arrays
+    """
+    raw = np.fromfile(path, dtype=np.uint8)
+    if raw[:8].tobytes() != b'CAMSHAP\0':
+        raise ValueError(f"{path} is not a CAMSHAP result file")
+    pos = 12
+    sample, cls, time, shap = [], [], [], []
+    while pos < len(raw):
+        sampleId, classId, timeNs, numValue = np.frombuffer(raw[pos:pos+20].tobytes(), dtype=np.dtype([('s', '<u4'), ('c', '<u4'), ('t', '<u8'), ('n', '<u4')]))[0]
+        pos += 20
+        sample.append(sampleId)
+        cls.append(classId)
+        time.append(timeNs)
+        shap.append(np.frombuffer(raw[pos:pos+4*numValue].tobytes(), dtype='<f4'))
+        pos += 4*int(numValue)
+    return np.array(sample), np.array(cls), np.array(time), np.array(shap)
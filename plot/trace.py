@@ -0,0 +1,46 @@
+# MIT License
+
+# Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+		
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+import glob
+import json
+import os
+
+def mergeTrace(logDir, output='trace.json'):
+    """!
+    @brief      Merge the <name>.trace.json files of all components into one Chrome/Perfetto trace.
+    @details    Each component writes the spans of the traced samples (control_node traceEvery) to its own file at finish.
+                Every component is a thread of the trace, and each span holds its sample id in args.
+    @param[in]  logDir:         Output directory of the simulation
+    @param[in]  output:         Name of the merged trace in logDir
+    @return     Number of spans, and number of spans dropped by full trace buffers
+    """
+    events, dropped = [], 0
+    for path in sorted(glob.glob(os.path.join(logDir, '*.trace.json'))):
+        if os.path.basename(path) == output:
+            continue
+        with open(path) as f:
+            trace = json.load(f)
+        events += trace['traceEvents']
+        dropped += trace.get('otherData', {}).get('dropped', 0)
+    with open(os.path.join(logDir, output), 'w') as f:
+        json.dump({'traceEvents': events, 'displayTimeUnit': 'ns', 'otherData': {'dropped': dropped}}, f)
+    return sum(1 for e in events if e['ph'] == 'X'), dropped
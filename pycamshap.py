@@ -1,45 +1,45 @@
-# MIT License
-
-# Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-		
-# Permission is hereby granted, free of charge, to any person obtaining a copy
-# of this software and associated documentation files (the "Software"), to deal
-# in the Software without restriction, including without limitation the rights
-# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-# copies of the Software, and to permit persons to whom the Software is
-# furnished to do so, subject to the following conditions:
-
-# The above copyright notice and this permission notice shall be included in all
-# copies or substantial portions of the Software.
-
-# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-# SOFTWARE.
-
-import sst
-import numpy as np
-import copy
-
-class Params(dict):
-    def __missing__(self, key):
-        print("Please enter %s: "%key)
-        val = input()
-        self[key] = val
-        return val
-    def subset(self, keys, optKeys = []):
-        ret = dict((k, self[k]) for k in keys)
-        for k in optKeys:
-            if k in self:
-                ret[k] = self[k]
-        return ret
-    def subsetWithRename(self, keys):
-        ret = dict()
-        for k,nk in keys:
-            if k in self:
-                ret[nk] = self[k]
-        return ret
-
+# MIT License
+
+# Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+		
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+import sst
+import numpy as np
+import copy
+
+class Params(dict):
+    def __missing__(self, key):
+        print("Please enter %s: "%key)
+        val = input()
+        self[key] = val
+        return val
+    def subset(self, keys, optKeys = []):
+        ret = dict((k, self[k]) for k in keys)
+        for k in optKeys:
+            if k in self:
+                ret[k] = self[k]
+        return ret
+    def subsetWithRename(self, keys):
+        ret = dict()
+        for k,nk in keys:
+            if k in self:
+                ret[nk] = self[k]
+        return ret
+
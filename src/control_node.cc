@@ -1,596 +1,343 @@
-// MIT License
-//
-// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-//		
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
-// 
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
-
-#include "control_node.h"
-
-using namespace SST;
-using namespace SST::CAMSHAP;
-
-control_node::control_node(ComponentId_t id, Params &params) : Component(id) {
-    
-    /* Read parameters */
-    uint32_t verbose        = params.find<uint32_t>("verbose", 0);
-    uint32_t mask           = params.find<uint32_t>("mask", 0);
-    std::string name        = params.find<std::string>("name");
-    UnitAlgebra freq        = params.find<UnitAlgebra>("freq", "1GHz");
-    uint32_t numFeature     = params.find<uint32_t>("numFeature", 10);
-    uint32_t numClass       = params.find<uint32_t>("numClass", 1);
-
-    std::vector<std::uint32_t> instructionTable;
-    params.find_array<std::uint32_t>("instructionTable", instructionTable);
-    assert(instructionTable.size() % INSTRUCTION_FIELD == 0);
-    uint32_t numInstruction = static_cast<uint32_t>(static_cast<double>(instructionTable.size())/INSTRUCTION_FIELD);
-    
-    instructionMemory.resize(numInstruction);
-    for (uint32_t i = 0, j = 0; i < numInstruction; ++i, j+=INSTRUCTION_FIELD){
-        instructionMemory[i] = new InstructionEntry(instructionTable[j], instructionTable[j+1], instructionTable[j+2], instructionTable[j+3], instructionTable[j+4], instructionTable[j+5], instructionTable[j+6]);
-    }
-    std::vector<std::uint8_t> dataMemoryTable;
-    params.find_array<std::uint8_t>("dataMemoryTable", dataMemoryTable);
-    dataMemory = new DataMemory(dataMemoryTable, 0, numClass*numFeature*4-1, this);
-    RegINT.resize(32);
-    RegFP.resize(32);
-
-    /* Configure output (outStd: command prompt, outFile: txt file) */
-    std::string outputDir   = params.find<std::string>("outputDir");
-    std::string prefix = "@t ["+name+"]:";
-    outStd.init(prefix, verbose, mask, Output::STDOUT);
-    outFile.init("@t ", verbose, mask, Output::FILE, outputDir+name+".txt");
-    outResult.init("@t ", verbose, mask, Output::FILE, outputDir+"result.txt");
-    outLatency.init("@t ", verbose, mask, Output::FILE, outputDir+"latency.txt");
-
-    /* Register clock handler */ 
-    clockHandler = new Clock::Handler<control_node>(this, &control_node::clockTick);
-    clockPeriod = registerClock(freq, clockHandler);
-
-    /* Configure links */
-    toRouterLink    = configureLink("toRouterPort");
-    fromRouterLink  = configureLink("fromRouterPort", new Event::Handler<control_node>(this, &control_node::handleRouter));
-
-    /* Register statistics */
-    activeCycleF    = registerStatistic<uint32_t>("activeCycleF");
-    activeCycleD    = registerStatistic<uint32_t>("activeCycleD");
-    activeCycleM    = registerStatistic<uint32_t>("activeCycleM");
-    activeCycleALU  = registerStatistic<uint32_t>("activeCycleALU");
-    activeCycleFPU  = registerStatistic<uint32_t>("activeCycleFPU");
-
-    /* Register it as primary component so that it should be completed to finish the simulation */
-    registerAsPrimaryComponent();
-    primaryComponentDoNotEndSim();
-}
-void
-control_node::setup() {
-    pc = 0;
-    fetch_ready = true;
-    fetch_update = false;
-
-    decode_ready = true;
-    decode_update = false;
-    decode_cmd = Instrn::OP_IMM;
-    decode_pc = 0;
-    decode_rd = 0;
-    decode_rs1 = 0;
-    decode_rs2 = 0;
-    decode_frs1 = 0.0;
-    decode_frs2 = 0.0;
-    decode_imm = 0;
-    decode_funct3 = 0;
-    decode_funct7 = 0;
-
-    execute_ready = true;
-    execute_update = false;
-    execute_cmd = Instrn::OP_IMM;
-    execute_rd = 0;
-    execute_rs1 = 0;
-    execute_rs2 = 0;
-    execute_frs1 = 0.0;
-    execute_frs2 = 0.0;
-    execute_imm = 0;
-    execute_funct3 = 0;
-    execute_funct7 = 0;
-
-    memory_ready = true;
-    memory_update = false;
-    memory_cmd = Instrn::OP_IMM;
-    memory_rd = 0;
-    memory_rs1 = 0;
-    memory_frs1 = 0.0;
-
-    write_ready = true;
-    write_update = false;
-    write_cmd = Instrn::OP_IMM;
-    write_end = false;
-}
-
-void
-control_node::handleRouter(Event *ev) {
-    CAMSHAPEvent *event = static_cast<CAMSHAPEvent*>(ev);
-    if (event->getOpcode() == static_cast<uint32_t>(Instrn::COPY)){
-        uint32_t size = event->getPayload().size();
-        for (uint32_t i = 0; i < size; i++){
-            uint32_t j  = dataMemory->getIndex();
-            dataMemory->putINT_1B(j, event->getPayload()[i]);
-        }
-        dataMemory->putINT_1B(24604, 1);
-        activeCycleM->addData(2);
-        outFile.verbose(CALL_INFO, 1, (1<<1), "%10s - %5s %5s %5s %5s = %.5f\n", "Input result", std::to_string(event->getPayload()[3]).c_str(), std::to_string(event->getPayload()[2]).c_str(), std::to_string(event->getPayload()[1]).c_str(), std::to_string(event->getPayload()[0]).c_str(), convertINTtoFP32(event->getPayload()[0], event->getPayload()[1], event->getPayload()[2], event->getPayload()[3]));
-    }
-    else{
-        outFile.fatal(CALL_INFO, -1, "Unknown opcode:%5" PRIu32 "\n", event->getOpcode());
-    }
-    delete ev;
-}
-
-void control_node::resetPipeline(uint32_t newPc){
-    pc = newPc;
-    fetch_ready = true;
-    fetch_update = false;
-
-    decode_ready = true;
-    decode_update = false;
-    decode_cmd = Instrn::OP_IMM;
-    decode_pc = 0;
-    decode_rd = 0;
-    decode_rs1 = 0;
-    decode_rs2 = 0;
-    decode_frs1 = 0.0;
-    decode_frs2 = 0.0;
-    decode_imm = 0;
-    decode_funct3 = 0;
-    decode_funct7 = 0;
-
-    execute_ready = true;
-    execute_update = false;
-    execute_cmd = Instrn::OP_IMM;
-    execute_rd = 0;
-    execute_rs1 = 0;
-    execute_rs2 = 0;
-    execute_frs1 = 0.0;
-    execute_frs2 = 0.0;
-    execute_imm = 0;
-    execute_funct3 = 0;
-    execute_funct7 = 0;
-
-    memory_ready = true;
-    memory_update = false;
-    memory_cmd = Instrn::OP_IMM;
-    memory_rd = 0;
-    memory_rs1 = 0;
-    memory_frs1 = 0.0;
-
-    write_ready = true;
-    write_update = false;
-    write_cmd = Instrn::OP_IMM;
-    write_end = false;
-}
-
-bool
-control_node::performFetch(){
-    activeCycleF->addData(1);
-    if (pc > instructionMemory.size()){
-        outFile.fatal(CALL_INFO, -1, "PC is out of range: PC %5" PRIu32 " > Instruction memory size %5" PRIu64 "\n", pc, instructionMemory.size());
-        return false;
-    }
-    else{
-        decode_pc = pc;
-        pc++;
-        outFile.verbose(CALL_INFO, 2, (1<<5), "%10s - PC:%3" PRIu32 "\n", "Fetch", decode_pc);
-        return true;
-    }
-}
-
-bool
-control_node::performDecode(){
-    activeCycleD->addData(1);
-    bool update = true;
-    InstructionEntry *instrn = instructionMemory[decode_pc];
-    decode_cmd = instrn->getCmd();
-    switch (decode_cmd){
-        case Instrn::COPY:
-            decode_rs1      = RegINT[instrn->getRs1()];
-            decode_rs2      = RegINT[instrn->getRs2()];
-            decode_funct3   = instrn->getFunct3();
-            break;
-        case Instrn::LOAD:
-        case Instrn::LOAD_FP:
-        case Instrn::OP_IMM:
-            decode_rd       = instrn->getRd();
-            decode_rs1      = RegINT[instrn->getRs1()];
-            decode_imm      = instrn->getImm();
-            decode_funct3   = instrn->getFunct3();
-            break;
-        case Instrn::STORE:
-            decode_rs1      = RegINT[instrn->getRs1()];
-            decode_rs2      = RegINT[instrn->getRs2()];
-            decode_imm      = instrn->getImm();
-            decode_funct3   = instrn->getFunct3();
-            break;
-        case Instrn::STORE_FP:
-            decode_rs1      = RegINT[instrn->getRs1()];
-            decode_frs2     = RegFP[instrn->getRs2()];
-            decode_imm      = instrn->getImm();
-            decode_funct3   = instrn->getFunct3();
-            break;
-        case Instrn::OP:
-            decode_rd       = instrn->getRd();
-            decode_rs1      = RegINT[instrn->getRs1()];
-            decode_rs2      = RegINT[instrn->getRs2()];
-            decode_funct3   = instrn->getFunct3();
-            decode_funct7   = instrn->getFunct7();
-            break;
-        case Instrn::OP_FP:
-            decode_rd       = instrn->getRd();
-            decode_frs1     = RegFP[instrn->getRs1()];
-            decode_frs2     = RegFP[instrn->getRs2()];
-            decode_funct3   = instrn->getFunct3();
-            decode_funct7   = instrn->getFunct7();
-            break;
-        case Instrn::LUI:
-            decode_rd       = instrn->getRd();
-            decode_imm      = instrn->getImm();
-            break;
-        case Instrn::BRANCH:
-            decode_rs1      = RegINT[instrn->getRs1()];
-            decode_rs2      = RegINT[instrn->getRs2()];
-            decode_imm      = instrn->getImm();
-            decode_funct3   = instrn->getFunct3();
-            break;
-        case Instrn::RET:
-            break;
-        default:
-            outFile.fatal(CALL_INFO, -1, "Decode: Unknown opcode:%5" PRIu32 "\n", static_cast<uint32_t>(decode_cmd));
-            break;
-    }
-    outFile.verbose(CALL_INFO, 2, (1<<5), "%10s - Opcode:%3" PRIu32 ", Rd:%8" PRIu32 ", Rs1:%8" PRIu32 ", Rs2:%8" PRIu32 ", Imm:%8" PRIu32 ", FRs1:%8.3f, FRs2:%8.3f, Funct3:%8" PRIu32", Funct7:%8" PRIu32"\n", "Decode", static_cast<uint32_t>(decode_cmd), decode_rd, decode_rs1, decode_rs2, decode_imm, decode_frs1, decode_frs2, decode_funct3, decode_funct7);
-    return update;
-}
-
-bool
-control_node::performExecute(){
-    bool update = true;
-    execute_cmd = decode_cmd;
-    switch (execute_cmd){
-        case Instrn::COPY:
-            execute_rs1     = decode_rs1;
-            execute_rs2     = decode_rs2;
-            execute_funct3  = decode_funct3;
-            break;
-        case Instrn::LOAD:
-            activeCycleALU->addData(1);
-            execute_rd      = decode_rd;
-            execute_rs1     = decode_rs1 + decode_imm;
-            break;
-        case Instrn::LOAD_FP:
-            activeCycleALU->addData(1);
-            execute_rd      = decode_rd;
-            execute_rs1     = decode_rs1 + decode_imm;
-            break;
-        case Instrn::STORE:
-            activeCycleALU->addData(1);
-            execute_rs1     = decode_rs1 + decode_imm;
-            execute_rs2     = decode_rs2;
-            break;
-        case Instrn::STORE_FP:
-            activeCycleALU->addData(1);
-            execute_rs1     = decode_rs1 + decode_imm;
-            execute_frs2    = decode_frs2;
-            break;
-        case Instrn::OP_IMM:{
-            activeCycleALU->addData(1);
-            execute_rd      = decode_rd;
-            switch (decode_funct3){
-                case 0:
-                    execute_rs1 = decode_rs1 + decode_imm;
-                    break;
-                case 1:
-                    execute_rs1 = decode_rs1 << (decode_imm & 0x1f);
-                    break;
-            }
-            break;
-        }
-        case Instrn::OP:{
-            activeCycleALU->addData(1);
-            execute_rd      = decode_rd;
-            switch (decode_funct3){
-                case 0:{
-                    switch (decode_funct7){
-                        case 0:
-                            execute_rs1 = decode_rs1 + decode_rs2;
-                            break;
-                        case 1:
-                            execute_rs1 = decode_rs1 * decode_rs2;
-                            break;
-                    }
-                    break;
-                }
-            }
-            break;
-        }
-        case Instrn::LUI:
-            activeCycleALU->addData(1);
-            execute_rd      = decode_rd;
-            execute_rs1     = decode_imm << 12;
-            break;
-        case Instrn::OP_FP:{
-            activeCycleFPU->addData(1);
-            execute_rd      = decode_rd;
-            switch (decode_funct7){
-                case 0:
-                    execute_frs1 = decode_frs1 + decode_frs2;
-                    break;
-                case 12:
-                    execute_frs1 = decode_frs1 / decode_frs2;
-                    break;
-            }
-            break;
-        }
-        case Instrn::BRANCH:{
-            activeCycleALU->addData(1);
-            int32_t offset = std::pow(-1, decode_imm >> 11) * (decode_imm & 0xff);
-            switch (decode_funct3){
-                case 0:{
-                    if (decode_rs1 == decode_rs2){
-                        resetPipeline(pc + offset);
-                        update = false;
-                    }
-                    break;
-                }
-                case 1:{
-                    if (decode_rs1 != decode_rs2){
-                        resetPipeline(pc + offset);
-                        update = false;
-                    }
-                    break;
-                }
-            }
-            break;
-        }
-        case Instrn::RET:
-            break;
-        default:
-            outFile.fatal(CALL_INFO, -1, "Execute: Unknown opcode:%5" PRIu32 "\n", static_cast<uint32_t>(execute_cmd));
-            break;
-    }
-    outFile.verbose(CALL_INFO, 2, (1<<5), "%10s - Opcode:%3" PRIu32 ", Rd:%8" PRIu32 ", Rs1:%8" PRIu32 ", Rs2:%8" PRIu32 ", Imm:%8" PRIu32 ", FRs1:%8.3f, FRs2:%8.3f, Funct3:%8" PRIu32", Funct7:%8" PRIu32"\n", "Execute", static_cast<uint32_t>(execute_cmd), execute_rd, execute_rs1, execute_rs2, execute_imm, execute_frs1, execute_frs2, execute_funct3, execute_funct7);
-    return update;
-}
-
-/**
- * @brief Process an event.
- */
-bool
-control_node::performMemory(){
-    bool update = true;
-    memory_cmd      = execute_cmd;
-    memory_rd       = execute_rd;
-    memory_rs1      = execute_rs1;
-    memory_frs1     = execute_frs1;
-    switch (memory_cmd){
-        case Instrn::COPY:
-            activeCycleM->addData(1);
-            dataMemory->sendVector(execute_rs1, execute_rs2, execute_funct3);
-            break;
-        case Instrn::LOAD:
-            activeCycleM->addData(1);
-            memory_rs1 = dataMemory->getINT_4B(execute_rs1);
-            break;
-        case Instrn::LOAD_FP:
-            activeCycleM->addData(1);
-            memory_frs1 = dataMemory->getFP_4B(execute_rs1);
-            break;
-        case Instrn::STORE:
-            activeCycleM->addData(1);
-            dataMemory->putINT_4B(execute_rs1, execute_rs2);
-            break;
-        case Instrn::STORE_FP:
-            activeCycleM->addData(1);
-            dataMemory->putFP_4B(execute_rs1, execute_frs2);
-            break;
-        case Instrn::OP_IMM:
-        case Instrn::OP:
-        case Instrn::LUI:
-        case Instrn::OP_FP:
-        case Instrn::BRANCH:
-        case Instrn::RET:
-            break;
-        default:
-            outFile.fatal(CALL_INFO, -1, "Memory: Unknown opcode:%5" PRIu32 "\n", static_cast<uint32_t>(memory_cmd));
-            break;
-    }
-    outFile.verbose(CALL_INFO, 2, (1<<5), "%10s - Opcode:%3" PRIu32 ", Rd:%8" PRIu32 ", Rs1:%8" PRIu32 ", FRs1:%8.3f\n", "Memory", static_cast<uint32_t>(memory_cmd), memory_rd, memory_rs1, memory_frs1);
-    return update;
-}
-
-bool
-control_node::performWriteBack(){
-    bool update = true;
-    write_cmd       = memory_cmd;
-    switch (write_cmd){
-        case Instrn::LOAD:
-        case Instrn::OP_IMM:
-        case Instrn::OP:
-        case Instrn::LUI:
-            RegINT[memory_rd] = memory_rs1;
-            break;
-        case Instrn::OP_FP:
-        case Instrn::LOAD_FP:
-            RegFP[memory_rd] = memory_frs1;
-            break;
-        case Instrn::STORE:
-        case Instrn::STORE_FP:
-        case Instrn::BRANCH:
-        case Instrn::COPY:
-            break;
-        case Instrn::RET:
-            write_end = true;
-            break;
-        default:
-            outFile.fatal(CALL_INFO, -1, "Memory: Unknown opcode:%5" PRIu32 "\n", static_cast<uint32_t>(write_cmd));
-            break;
-    }
-    outFile.verbose(CALL_INFO, 2, (1<<5), "%10s - Opcode:%3" PRIu32 ", Rd:%8" PRIu32 ", Rs1:%8" PRIu32 ", FRs1:%8.3f\n", "WriteBack", static_cast<uint32_t>(write_cmd), memory_rd, memory_rs1, memory_frs1);
-    return update;
-}
-
-bool
-control_node::clockTick(Cycle_t cycle) {
-    
-
-    if (write_ready){
-        if (memory_update){
-            write_update = performWriteBack();
-        }
-        if (memory_ready){
-            if (execute_update){
-                memory_update = performMemory();
-            }
-            if (execute_ready){
-                if (decode_update){
-                    execute_update = performExecute();
-                }
-                if (decode_ready){
-                    if (fetch_update){
-                        decode_update = performDecode();
-                    }
-                    if (fetch_ready){
-                        fetch_update = performFetch();
-                    }
-                }
-            }
-        }
-    }
-    if (write_end){
-        primaryComponentOKToEndSim();
-        return true;
-    }
-
-    outFile.verbose(CALL_INFO, 2, (1<<5), "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "\n", RegINT[10], RegINT[11], RegINT[12], RegINT[13], RegINT[14], RegINT[15], RegINT[16], RegINT[17], RegINT[18], RegINT[19]);
-    outFile.verbose(CALL_INFO, 2, (1<<5), "%8.3f %8.3f %8.3f %8.3f %8.3f\n\n", RegFP[0], RegFP[1], RegFP[2], RegFP[3], RegFP[4]);
-    outFile.verbose(CALL_INFO, 2, (1<<5), "%8.3f %8.3f %8.3f %8.3f %8.3f\n\n", dataMemory->getFP_4B(4096), dataMemory->getFP_4B(4096+4), dataMemory->getFP_4B(4096+8), dataMemory->getFP_4B(4096+12), dataMemory->getFP_4B(4096+16));
-    return false;
-}
-
-Instrn
-control_node::InstructionEntry::getCmd(){
-    switch(opcode){
-        case(0):
-            return Instrn::RET;
-        case(11):
-            return Instrn::COPY;
-        case(3):
-            return Instrn::LOAD;
-        case(7):
-            return Instrn::LOAD_FP;
-        case(19):
-            return Instrn::OP_IMM;
-        case(35):
-            return Instrn::STORE;
-        case(39):
-            return Instrn::STORE_FP;
-        case(51):
-            return Instrn::OP;
-        case(55):
-            return Instrn::LUI;
-        case(83):
-            return Instrn::OP_FP;
-        case(99):
-            return Instrn::BRANCH;
-        default:
-            return Instrn::OP_IMM;
-    }
-}
-
-void
-control_node::DataMemory::sendVector(uint32_t addr, uint32_t size, uint32_t funct3){
-    std::vector<uint8_t> vec;
-    for (uint32_t i=0; i < size; i++){
-        vec.push_back(entry[addr+i]);
-    }
-    switch (funct3){
-        case (0):{
-            for (uint32_t i = 0; i < size; i+=4){
-                m_control_node->outResult.output("%.3f ", getFP_4B(addr+i));
-                putFP_4B(addr+i, 0.0);
-            }
-            m_control_node->outResult.output("\n");
-            m_control_node->outLatency.output("%" PRIu64 " us\n", m_control_node->getCurrentSimTimeMicro());
-            break;
-        }
-        case (1):{
-            CAMSHAPEvent *ev_send = new CAMSHAPEvent(static_cast<uint32_t>(Instrn::COPY), 0, 0, 0, 0, vec);
-            m_control_node->toRouterLink->send(ev_send);
-            break;
-        }
-    }
-}
-
-uint32_t
-control_node::DataMemory::getINT_4B(uint32_t addr){
-    uint32_t value = (entry[addr+3] << 24) + (entry[addr+2] << 16) + (entry[addr+1] << 8) + (entry[addr]);
-    return value;
-}
-
-float_t
-control_node::DataMemory::getFP_4B(uint32_t addr){
-    uint32_t value = (entry[addr+3] << 24) + (entry[addr+2] << 16) + (entry[addr+1] << 8) + (entry[addr]);
-    float_t* fp = reinterpret_cast<float_t*>(&value);
-    return *fp;
-}
-
-void
-control_node::DataMemory::putFP_4B(uint32_t addr, float_t fp){
-    uint32_t* fp32 = reinterpret_cast<uint32_t*>(&fp);
-    // Little-endian
-    entry[addr] = *fp32 & 0xff;
-    entry[addr+1] = (*fp32>>8) & 0xff;
-    entry[addr+2] = (*fp32>>16) & 0xff;
-    entry[addr+3] = (*fp32>>24) & 0xff;
-}
-
-void
-control_node::DataMemory::putINT_4B(uint32_t addr, uint32_t value){
-    // Little-endian
-    entry[addr] = value & 0xff;
-    entry[addr+1] = (value>>8) & 0xff;
-    entry[addr+2] = (value>>16) & 0xff;
-    entry[addr+3] = (value>>24) & 0xff;
-}
-
-uint32_t
-control_node::DataMemory::getIndex(){
-    uint32_t current_index = index;
-    if (current_index <= base.second){
-        index++;
-        return current_index;
-    }
-    else{
-        index = base.first+1;
-        return base.first;
-    }   
-}
-
-float_t
-control_node::convertINTtoFP32(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth){
-    uint32_t value = (fourth << 24) + (third << 16) + (second << 8) + (first);
-    float_t* fp = reinterpret_cast<float_t*>(&value);
-    return *fp;
-}
\ No newline at end of file
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "control_node.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace SST;
+using namespace SST::CAMSHAP;
+
+control_node::control_node(ComponentId_t id, Params &params) : Component(id) {
+    
+    /* Read parameters */
+    uint32_t verbose        = params.find<uint32_t>("verbose", 0);
+    uint32_t mask           = params.find<uint32_t>("mask", 0);
+    std::string name        = params.find<std::string>("name");
+    UnitAlgebra freq        = params.find<UnitAlgebra>("freq", "1GHz");
+    uint32_t numFeature     = params.find<uint32_t>("numFeature", 10);
+    numClass                = params.find<uint32_t>("numClass", 1);
+    tileBegin               = params.find<uint32_t>("tileBegin", 0);
+    tileEnd                 = params.find<uint32_t>("tileEnd", UINT32_MAX);
+    traceEvery              = params.find<uint32_t>("traceEvery", 0);
+    params.find_array<std::uint32_t>("tilePerClass", tilePerClass);
+    assert(tilePerClass.size() % 2 == 0);
+
+    std::vector<std::uint8_t> dataMemoryTable;
+    params.find_array<std::uint8_t>("dataMemoryTable", dataMemoryTable);
+    resultIndex             = 0;
+
+    /* Configure output (outStd: command prompt, outFile: txt file) */
+    std::string outputDir   = params.find<std::string>("outputDir");
+    std::string prefix = "@t ["+name+"]:";
+    outStd.init(prefix, verbose, mask, Output::STDOUT);
+    outFile.init("@t ", verbose, mask, Output::FILE, outputDir+name+".txt");
+
+    /* Load instruction/data memory */
+    memoryMap = MemoryMap({
+        {"result",      0,      numClass*numFeature*4},
+        {"resultFlag",  24604,  1},
+        {"input",       8192,   numFeature},
+        {"param",       24576,  28},
+    });
+    loadProgram(params, dataMemoryTable);
+    configureMode(params);
+    dmaEngine = loadUserSubComponent<DMAEngine>("dma", ComponentInfo::SHARE_NONE, dataMemory);
+
+    /* The test sample stream is opened in setup, so that a named pipe without writer cannot stall construction */
+    sampleStreamPath        = params.find<std::string>("sampleStream", "");
+    sampleStreamWait        = params.find<uint32_t>("sampleStreamWait", 60);
+    std::string resultFormat = params.find<std::string>("resultFormat", "text");
+    if (resultFormat == "binary"){
+        std::string csvPath = params.find<bool>("resultCSV", false) ? outputDir+"result.csv" : "";
+        if (!resultWriter.open(outputDir+"result.bin", params.find<uint32_t>("resultBuffer", 1 << 20), csvPath)){
+            outFile.fatal(CALL_INFO, -1, "Cannot open result files in %s\n", outputDir.c_str());
+        }
+    }
+    else if (resultFormat == "text"){
+        outResult.init("@t ", verbose, mask, Output::FILE, outputDir+"result.txt");
+        outLatency.init("@t ", verbose, mask, Output::FILE, outputDir+"latency.txt");
+    }
+    else{
+        outFile.fatal(CALL_INFO, -1, "Unknown resultFormat: %s\n", resultFormat.c_str());
+    }
+
+    /* Register clock handler */ 
+    clockHandler = new Clock::Handler<control_node>(this, &control_node::clockTick);
+    clockPeriod = registerClock(freq, clockHandler);
+    psTime      = getTimeConverter("1ps");
+    tracer.configure(params, outputDir+name+".trace.json", name, getId(), getTimeConverter("1us"));
+
+    /* Configure links */
+    toRouterLink    = configureLink("toRouterPort");
+    fromRouterLink  = configureLink("fromRouterPort", new Event::Handler<control_node>(this, &control_node::handleRouter));
+    configureWake();
+
+    /* Register statistics */
+    activeCycleF    = registerStatistic<uint32_t>("activeCycleF");
+    activeCycleD    = registerStatistic<uint32_t>("activeCycleD");
+    activeCycleM    = registerStatistic<uint32_t>("activeCycleM");
+    activeCycleALU  = registerStatistic<uint32_t>("activeCycleALU");
+    activeCycleFPU  = registerStatistic<uint32_t>("activeCycleFPU");
+    registerStallStatistics(STALL_MPE);
+    pollRegion      = {RESULT_FLAG};
+    sampleLatency   = registerStatistic<uint64_t>("sampleLatency");
+    throughput      = registerStatistic<double_t>("throughput");
+
+    /* Register it as primary component so that it should be completed to finish the simulation */
+    registerAsPrimaryComponent();
+    primaryComponentDoNotEndSim();
+}
+void
+control_node::setup() {
+    resetPipeline(0);
+    if (!sampleStreamPath.empty()){
+        openSampleStream();
+        refillInput();
+    }
+}
+
+/**
+ * @brief Open sampleStream without blocking on a named pipe.
+ * @details open() of a named pipe blocks until a writer connects, so the pipe is opened non-blocking and given
+ * sampleStreamWait seconds to deliver its first bytes. Reads then block as usual, and the writer closing the pipe ends
+ * the stream.
+ */
+void
+control_node::openSampleStream(){
+    sampleStream = ::open(sampleStreamPath.c_str(), O_RDONLY | O_NONBLOCK);
+    if (sampleStream < 0){
+        outFile.fatal(CALL_INFO, -1, "Cannot open sample stream %s: %s\n", sampleStreamPath.c_str(), std::strerror(errno));
+    }
+    struct stat info;
+    if (fstat(sampleStream, &info) == 0 && S_ISFIFO(info.st_mode)){
+        struct pollfd ready = {sampleStream, POLLIN, 0};
+        int found;
+        do {
+            found = poll(&ready, 1, int(sampleStreamWait) * 1000);
+        } while (found < 0 && errno == EINTR);
+        if (found <= 0){
+            outFile.fatal(CALL_INFO, -1, "No writer sent samples to named pipe %s within %" PRIu32 " s\n", sampleStreamPath.c_str(), sampleStreamWait);
+        }
+    }
+    fcntl(sampleStream, F_SETFL, fcntl(sampleStream, F_GETFL) & ~O_NONBLOCK);
+}
+
+void
+control_node::finish() {
+    if (lastCompletion > 0){
+        throughput->addData(double_t(numCompleted) * 1e12 / double_t(lastCompletion));
+    }
+    resultWriter.close();
+    tracer.dump();
+}
+
+void
+control_node::handleRouter(Event *ev) {
+    CAMSHAPEvent *event = static_cast<CAMSHAPEvent*>(ev);
+    if (event->getOpcode() == static_cast<uint32_t>(Instrn::COPY)){
+        activeCycleM->addData(2);
+        CAMSHAP_VERBOSE(outFile, 1, (1<<1), "%10s - %5s %5s %5s %5s = %.5f\n", "Input result", std::to_string(event->getPayload()[3]).c_str(), std::to_string(event->getPayload()[2]).c_str(), std::to_string(event->getPayload()[1]).c_str(), std::to_string(event->getPayload()[0]).c_str(), convertINTtoFP32(event->getPayload()[0], event->getPayload()[1], event->getPayload()[2], event->getPayload()[3]));
+        uint32_t index = getResultIndex(event->getPayload().size());
+        copyIn(index, std::move(event->getPayload()), [this](){
+            dataMemory->putINT_1B(memoryMap.base(RESULT_FLAG), 1);
+        });
+    }
+    else{
+        outFile.fatal(CALL_INFO, -1, "Unknown opcode:%5" PRIu32 "\n", event->getOpcode());
+    }
+    delete ev;
+}
+
+bool
+control_node::clockTick(Cycle_t cycle) {
+    step();
+    if (write_end){
+        primaryComponentOKToEndSim();
+        return true;
+    }
+
+    CAMSHAP_VERBOSE(outFile, 2, (1<<5), "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "%8" PRIu32 "\n", RegINT[10], RegINT[11], RegINT[12], RegINT[13], RegINT[14], RegINT[15], RegINT[16], RegINT[17], RegINT[18], RegINT[19]);
+    CAMSHAP_VERBOSE(outFile, 2, (1<<5), "%8.3f %8.3f %8.3f %8.3f %8.3f\n\n", RegFP[0], RegFP[1], RegFP[2], RegFP[3], RegFP[4]);
+    CAMSHAP_VERBOSE(outFile, 2, (1<<5), "%8.3f %8.3f %8.3f %8.3f %8.3f\n\n", dataMemory->getFP_4B(4096), dataMemory->getFP_4B(4096+4), dataMemory->getFP_4B(4096+8), dataMemory->getFP_4B(4096+12), dataMemory->getFP_4B(4096+16));
+    return suspendFunctional();
+}
+
+/**
+ * @brief Send a vector in data memory.
+ * @details funct3=0 writes the vector as the result of class dest for the oldest incomplete test sample: a binary record
+ * with resultFormat=binary, else values on the line of the sample in result.txt. The vector is cleared once written.
+ * funct3=1 sends the vector to router, multicast to the tiles of class dest-1 (dest=0: all tiles holding a class).
+ * funct3=2 sends it the same way and issues a test sample. The program marks one COPY per sample this way, whatever
+ * classes it sends to, and the numClass-th result written after it completes the sample.
+ * One issued sample out of every traceEvery is tagged with its sample id for tracing, and so is every funct3=1 COPY
+ * that follows it until the next sample is issued.
+ */
+void
+control_node::sendVector(uint32_t dest, uint32_t addr, uint32_t size, uint32_t funct3){
+    switch (funct3){
+        case (0):{
+            if (dest >= numClass){
+                outFile.fatal(CALL_INFO, -1, "Result of class %" PRIu32 " out of %" PRIu32 " classes\n", dest, numClass);
+            }
+            if (resultWriter.isOpen()){
+                resultValue.resize(size / 4);
+                for (uint32_t i = 0; i < size / 4; i++){
+                    resultValue[i] = dataMemory->getFP_4B(addr + 4*i);
+                }
+                resultWriter.write(numCompleted, dest, getCurrentSimTimeNano(), resultValue.data(), resultValue.size());
+                dataMemory->clear(addr, size);
+                completeResult();
+                break;
+            }
+            for (uint32_t i = 0; i < size; i+=4){
+                outResult.output("%.3f ", dataMemory->getFP_4B(addr+i));
+                dataMemory->putFP_4B(addr+i, 0.0);
+            }
+            completeResult();
+            if (numClassDone == 0){
+                outResult.output("\n");
+            }
+            break;
+        }
+        case (1):
+        case (2):{
+            uint32_t tileFirst = tileBegin;
+            uint32_t tileLast = tileEnd;
+            if (dest > 0){
+                if (2*dest > tilePerClass.size()){
+                    outFile.fatal(CALL_INFO, -1, "Unknown class:%5" PRIu32 "\n", dest-1);
+                }
+                tileFirst = tilePerClass[2*(dest-1)];
+                tileLast = tilePerClass[2*(dest-1)+1];
+            }
+            // A COPY out of the input region consumes the streamed sample
+            const MemoryRegion &input = memoryMap[INPUT];
+            bool consume = sampleStream >= 0 && addr < input.end() && addr + size > input.base;
+            if (consume && !inputValid){
+                outFile.fatal(CALL_INFO, -1, "Sample stream ended after %" PRIu64 " samples\n", numStreamed);
+            }
+            SimTime_t now = getCurrentSimCycle();
+            if (funct3 == 2){
+                issuedTraceId = Tracer::UNTRACED;
+                if (traceEvery > 0 && numIssued % traceEvery == 0){
+                    issuedTraceId = numIssued;
+                }
+                issued.push_back({now, issuedTraceId});
+                numIssued++;
+            }
+            uint32_t traceId = issuedTraceId;
+            copyOut(addr, size, [this, tileFirst, tileLast, traceId, now](Payload &&vec){
+                tracer.span("dispatch", traceId, now, getCurrentSimCycle());
+                toRouterLink->send((new CAMSHAPEvent(static_cast<uint32_t>(Instrn::COPY), 0, 0, 0, 0, std::move(vec), tileFirst, tileLast))->setTraceId(traceId));
+            });
+            if (consume){
+                refillInput();
+            }
+            break;
+        }
+        default:{
+            outFile.fatal(CALL_INFO, -1, "Unknown COPY funct3:%5" PRIu32 "\n", funct3);
+        }
+    }
+}
+
+/**
+ * @brief Count a written result, and complete the oldest issued sample once all its classes are written.
+ * @details Samples complete in issue order. With resultFormat=text, latency.txt gets one line per sample: the
+ * completion time in us as before ("<time> us"), then issue time, completion time and latency, all in ps.
+ */
+void
+control_node::completeResult(){
+    if (++numClassDone < numClass){
+        return;
+    }
+    numClassDone = 0;
+    if (issued.empty()){
+        CAMSHAP_VERBOSE(outFile, 1, (1<<5), "Result without an issued sample\n");
+        return;
+    }
+    Issue sample = issued.front();
+    issued.pop_front();
+    SimTime_t now = getCurrentSimCycle();
+    tracer.span("sample", sample.traceId, sample.time, now);
+    SimTime_t issue = sample.time / psTime->getFactor();
+    lastCompletion = now / psTime->getFactor();
+    numCompleted++;
+    sampleLatency->addData(lastCompletion - issue);
+    if (!resultWriter.isOpen()){
+        outLatency.output("%" PRIu64 " us %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", getCurrentSimTimeMicro(), issue, lastCompletion, lastCompletion - issue);
+    }
+}
+
+/**
+ * @brief Start of the next 'size' bytes of the result region, wrapping to the start once the region is full.
+ */
+uint32_t
+control_node::getResultIndex(uint32_t size){
+    const MemoryRegion &result = memoryMap[RESULT];
+    if (resultIndex + size > result.size){
+        resultIndex = 0;
+    }
+    uint32_t index = result.base + resultIndex;
+    resultIndex += size;
+    return index;
+}
+
+/**
+ * @brief Read the next test sample of the stream into the input region.
+ * @details The COPY that consumed the previous sample has already captured it, so the region is overwritten in place
+ * and memory stays bounded by one input region whatever the number of tests. The end of the stream only matters if
+ * the program asks for another sample.
+ */
+void
+control_node::refillInput(){
+    const MemoryRegion &input = memoryMap[INPUT];
+    sampleBuffer.resize(input.size);
+    uint32_t count = 0;
+    while (count < input.size){
+        ssize_t got = ::read(sampleStream, sampleBuffer.data() + count, input.size - count);
+        if (got < 0 && errno == EINTR){
+            continue;
+        }
+        if (got < 0){
+            outFile.fatal(CALL_INFO, -1, "Cannot read sample stream %s: %s\n", sampleStreamPath.c_str(), std::strerror(errno));
+        }
+        if (got == 0){
+            break;
+        }
+        count += got;
+    }
+    inputValid = (count == input.size);
+    if (inputValid){
+        dataMemory->write(input.base, sampleBuffer.data(), input.size);
+        numStreamed++;
+    }
+    else if (count > 0){
+        outFile.fatal(CALL_INFO, -1, "Sample stream ends with a partial sample of %5" PRIu32 " bytes\n", count);
+    }
+}
@@ -1,231 +1,185 @@
-// MIT License
-//
-// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-//		
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
-// 
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
-
-#ifndef _CONTROL_NODE_COMPONENT_H
-#define _CONTROL_NODE_COMPONENT_H
-
-#include "event.h"
-#include "instruction.h"
-
-#include <sst/core/component.h>
-#include <sst/core/link.h>
-#include <sst/core/timeConverter.h>
-#include <sst/core/timeLord.h>
-#include <sst/core/output.h>
-
-#include <fstream>
-#include <iostream>
-#include <vector>
-#include <map>
-#include <cmath> //std::ceil
-
-namespace SST {
-namespace CAMSHAP {
-
-class control_node : public SST::Component {
-    static const uint32_t INSTRUCTION_FIELD = 7;
-public:
-    SST_ELI_REGISTER_COMPONENT(
-        control_node,
-        "camshap",
-        "control_node",
-        SST_ELI_ELEMENT_VERSION(1,0,0),
-        "Control Unit of node",
-        COMPONENT_CATEGORY_UNCATEGORIZED
-    )
-    SST_ELI_DOCUMENT_PARAMS(
-        {"verbose",             "(uint) Output verbosity. The higher verbosity, the more debug info", "0"},
-        {"mask",                "(uint) Output mask", "0"},
-        {"name",                "(string) Name of component"},
-        {"freq",                "(UnitAlgebra) Clock frequency", "1GHz"},
-        {"instructionTable",    "(vector<uint32_t>) Instruction memory", " "},
-        {"dataMemoryTable",     "(vector<uint8_t>) Data memory", " "},
-        {"outputDir",           "(string) Path of output files", " "},
-    )
-    SST_ELI_DOCUMENT_PORTS(
-        {"toRouterPort",        "Port to router",           {"xtime_isa.XtimeEvent"}},
-        {"fromRouterPort",      "Port from router",         {"xtime_isa.XtimeEvent"}},
-    )
-    SST_ELI_DOCUMENT_STATISTICS(
-        { "activeCycleF",       "Active cycles of Fetch stage", "cycles", 1},
-        { "activeCycleD",       "Active cycles of Decode stage", "cycles", 1},
-        { "activeCycleM",       "Active cycles of Memory stage", "cycles", 1},
-        { "activeCycleALU",     "Active cycles of ALU stage", "cycles", 1},
-        { "activeCycleFPU",     "Active cycles of FPU stage", "cycles", 1},
-    )
-    SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
-    )
-
-public:
-    control_node(ComponentId_t id, Params& params);
-    ~control_node() { }
-
-    void init( uint32_t phase ) { }
-	void setup();
-    void finish() {}
-
-    void handleRouter( SST::Event* ev );
-    void resetPipeline( uint32_t newPC );
-    bool performFetch();
-    bool performDecode();
-    bool performExecute();
-    bool performMemory();
-    bool performWriteBack();
-    bool clockTick( Cycle_t cycle );
-    float_t convertINTtoFP32(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth);
-
-private:
-    class InstructionEntry{
-        public:
-            InstructionEntry(uint32_t _opcode, uint32_t _rd, uint32_t _rs1, uint32_t _rs2, uint32_t _imm, uint32_t _funct3, uint32_t _funct7):
-            opcode(_opcode), rd(_rd), rs1(_rs1), rs2(_rs2), imm(_imm), funct3(_funct3), funct7(_funct7) { }
-
-            uint32_t getOpcode() const { return opcode;}
-            uint32_t getRd() const { return rd;}
-            uint32_t getRs1() const { return rs1;}
-            uint32_t getRs2() const { return rs2;}
-            uint32_t getImm() const { return imm;}
-            uint32_t getFunct3() const { return funct3;}
-            uint32_t getFunct7() const { return funct7;}
-            Instrn getCmd();
-
-        private:
-            uint32_t opcode;
-            uint32_t rd;
-            uint32_t rs1;
-            uint32_t rs2;
-            uint32_t imm;
-            uint32_t funct3;
-            uint32_t funct7;
-    };
-
-    class DataMemory{
-        public:
-            DataMemory(std::vector<uint8_t> _entry, uint32_t base_min, uint32_t base_max, control_node *_control_node):
-            entry(_entry), m_control_node(_control_node) {
-                index = base_min;
-                base.first = base_min;
-                base.second = base_max;
-            }
-            
-            void sendVector(uint32_t addr, uint32_t size, uint32_t funct3);
-            uint32_t getINT_4B(uint32_t addr);
-            float_t getFP_4B(uint32_t addr);
-            void putFP_4B(uint32_t addr, float_t fp);
-            void putINT_4B(uint32_t addr, uint32_t value);
-            void putINT_1B(uint32_t addr, uint8_t value){
-                entry[addr] = value;
-            }
-            void putINT_2B(uint32_t addr, uint16_t value) {
-                entry[addr] = (value>>8) & 0xff;
-                entry[addr+1] = value & 0xff;
-            }
-            uint32_t getIndex();
-
-        private:
-            std::vector<uint8_t> entry;
-            std::pair<uint32_t, uint32_t> base;
-            uint32_t index;
-            control_node *m_control_node;
-    };
-
-    /** Clock *****************************************************************/
-    Clock::Handler<control_node>    *clockHandler;
-    TimeConverter                   *clockPeriod;
-
-    /** IO ********************************************************************/
-    Output                          outStd;
-    Output                          outFile;
-    Output                          outResult;
-    Output                          outLatency;
-
-    /** Link/Port *************************************************************/
-    Link*                           toRouterLink;
-    Link*                           fromRouterLink;
-    Link*                           memoryLink;
-
-    /** Pipeline Registers ****************************************************/
-    uint32_t                        pc;
-    bool                            fetch_ready;
-    bool                            fetch_update;
-
-    bool                            decode_ready;
-    bool                            decode_update;
-    Instrn                          decode_cmd;
-    uint32_t                        decode_pc;
-    uint32_t                        decode_rd;
-    uint32_t                        decode_rs1;
-    uint32_t                        decode_rs2;
-    float_t                         decode_frs1;
-    float_t                         decode_frs2;
-    uint32_t                        decode_imm;
-    uint32_t                        decode_funct3;
-    uint32_t                        decode_funct7;
-
-    bool                            execute_ready;
-    bool                            execute_update;
-    Instrn                          execute_cmd;
-    uint32_t                        execute_rd;
-    uint32_t                        execute_rs1;
-    uint32_t                        execute_rs2;
-    float_t                         execute_frs1;
-    float_t                         execute_frs2;
-    uint32_t                        execute_imm;
-    uint32_t                        execute_funct3;
-    uint32_t                        execute_funct7;
-
-    bool                            memory_ready;
-    bool                            memory_update;
-    Instrn                          memory_cmd;
-    uint32_t                        memory_rd;
-    uint32_t                        memory_rs1;
-    float_t                         memory_frs1;
-
-    bool                            write_ready;
-    bool                            write_update;
-    Instrn                          write_cmd;
-    bool                            write_end;
-
-    /** Parameters ************************************************************/
-    std::vector<InstructionEntry*>  instructionMemory;
-    DataMemory*                     dataMemory;
-    std::vector<uint32_t>           RegINT;
-    std::vector<float_t>            RegFP;
-
-    uint32_t                        routerFlitSize;
-    uint32_t                        memWidth;
-
-    /** Control signal ********************************************************/
-    bool                            busy = false;
-
-    /** Statistics ************************************************************/
-    Statistic<uint32_t>*            activeCycleF;
-    Statistic<uint32_t>*            activeCycleD;
-    Statistic<uint32_t>*            activeCycleM;
-    Statistic<uint32_t>*            activeCycleALU;
-    Statistic<uint32_t>*            activeCycleFPU;
-};
-
-}
-}
-
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _CONTROL_NODE_COMPONENT_H
+#define _CONTROL_NODE_COMPONENT_H
+
+#include "event.h"
+#include "instruction.h"
+#include "pipeline.h"
+#include "result_writer.h"
+
+#include <sst/core/component.h>
+#include <sst/core/link.h>
+#include <sst/core/timeConverter.h>
+#include <sst/core/timeLord.h>
+#include <sst/core/output.h>
+
+#include <fstream>
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+#include <map>
+#include <deque>
+#include <cmath> //std::ceil
+
+namespace SST {
+namespace CAMSHAP {
+
+class control_node : public SST::Component, public Pipeline<control_node> {
+    friend class Pipeline<control_node>;
+    static const uint32_t PIPELINE_MASK = (1<<5);
+    /** Regions of memoryMap */
+    enum Region { RESULT, RESULT_FLAG, INPUT, PARAM };
+public:
+    SST_ELI_REGISTER_COMPONENT(
+        control_node,
+        "camshap",
+        "control_node",
+        SST_ELI_ELEMENT_VERSION(1,0,0),
+        "Control Unit of node",
+        COMPONENT_CATEGORY_UNCATEGORIZED
+    )
+    SST_ELI_DOCUMENT_PARAMS(
+        {"verbose",             "(uint) Output verbosity. The higher verbosity, the more debug info", "0"},
+        {"mask",                "(uint) Output mask", "0"},
+        {"name",                "(string) Name of component"},
+        {"freq",                "(UnitAlgebra) Clock frequency", "1GHz"},
+        {"instructionTable",    "(vector<uint32_t>) Instruction memory", " "},
+        {"dataMemoryTable",     "(vector<uint8_t>) Data memory", " "},
+        {"mode",                "(string) cycle: 5-stage pipeline, functional: one instruction per step with analytic cycle cost", "cycle"},
+        {"functionalUntil",     "(UnitAlgebra) Simulated time at which functional mode switches to cycle mode (requires mode=functional; the reverse switch is not supported). Empty: never", " "},
+        {"memorySize",          "(uint) Minimum size of data memory in bytes. It also grows to hold dataMemoryTable and every region", "0"},
+        {"memoryMap.result",    "(vector<uint32_t>) [base, size] of the results received from the tiles", "[0, numClass*numFeature*4]"},
+        {"memoryMap.resultFlag","(vector<uint32_t>) [base, size] of the flag set when a result arrives", "[24604, 1]"},
+        {"memoryMap.input",     "(vector<uint32_t>) [base, size] of the test sample streamed from sampleStream", "[8192, numFeature]"},
+        {"memoryMap.param",     "(vector<uint32_t>) [base, size] of the parameter block read by the program", "[24576, 28]"},
+        {"sampleStream",        "(string) Binary file or named pipe of uint8 test samples, read one input region at a time. Empty: samples come from dataMemoryTable", ""},
+        {"sampleStreamWait",    "(uint) Seconds a named pipe sampleStream may take to deliver its first bytes at setup before the run fails", "60"},
+        {"tilePerClass",        "(vector<uint32_t>) First and last tile of each class. COPY to router with rd=k is multicast to tiles of class k-1", " "},
+        {"tileBegin",           "(uint) First tile holding any class. COPY to router with rd=0 is multicast from this tile", "0"},
+        {"tileEnd",             "(uint) Last tile holding any class. COPY to router with rd=0 is multicast up to this tile", "4294967295"},
+        {"resultFormat",        "(string) text: result.txt (one line per test sample, its classes in turn) and latency.txt, binary: one full-precision record per test sample and class in result.bin", "text"},
+        {"resultCSV",           "(bool) With binary results, also mirror them to result.csv", "false"},
+        {"resultBuffer",        "(uint) Bytes of results buffered before a write to disk", "1048576"},
+        {"numClass",            "(uint) Number of classes. A sample completes once its numClass results are written", "1"},
+        {"traceEvery",          "(uint) Trace one test sample out of every traceEvery through all components, to <name>.trace.json. 0: no tracing", "0"},
+        {"traceBuffer",         "(uint) Spans kept by the tracer, the oldest are overwritten", "65536"},
+        {"outputDir",           "(string) Path of output files", " "},
+    )
+    SST_ELI_DOCUMENT_PORTS(
+        {"toRouterPort",        "Port to router",           {"xtime_isa.XtimeEvent"}},
+        {"fromRouterPort",      "Port from router",         {"xtime_isa.XtimeEvent"}},
+    )
+    SST_ELI_DOCUMENT_STATISTICS(
+        { "activeCycleF",       "Active cycles of Fetch stage", "cycles", 1},
+        { "activeCycleD",       "Active cycles of Decode stage", "cycles", 1},
+        { "activeCycleM",       "Active cycles of Memory stage", "cycles", 1},
+        { "activeCycleALU",     "Active cycles of ALU stage", "cycles", 1},
+        { "activeCycleFPU",     "Active cycles of FPU stage", "cycles", 1},
+        { "stallCycle",         "Stall cycles, each under one reason; poll replaces hazard and flush while spinning on an unchanged mailbox (subId: hazard, copy, flush, poll)", "cycles", 1},
+        { "sampleLatency",      "Latency of each test sample, from its issuing COPY (funct3=2) to its last result (use sst.HistogramStatistic for percentiles)", "ps", 1},
+        { "throughput",         "Completed test samples per second of simulated time, recorded at finish", "samples/s", 1},
+    )
+    SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
+        {"dma",                 "DMA engine for COPY transfers. Empty: transfers complete at once", "SST::CAMSHAP::DMAEngine"},
+    )
+
+public:
+    control_node(ComponentId_t id, Params& params);
+    ~control_node() { if (sampleStream >= 0) ::close(sampleStream); }
+
+    void init( uint32_t phase ) { }
+	void setup();
+    void finish();
+
+    void handleRouter( SST::Event* ev );
+    bool clockTick( Cycle_t cycle );
+
+private:
+    /** Pipeline policy *******************************************************/
+    void sendVector(uint32_t dest, uint32_t addr, uint32_t size, uint32_t funct3);
+    uint32_t getResultIndex(uint32_t size);
+    void openSampleStream();
+    void refillInput();
+    void completeResult();
+
+    /** Clock *****************************************************************/
+    Clock::Handler<control_node>    *clockHandler;
+    TimeConverter                   *clockPeriod;
+    TimeConverter                   *psTime;
+
+    /** IO ********************************************************************/
+    Output                          outStd;
+    Output                          outFile;
+    Output                          outResult;
+    Output                          outLatency;
+    ResultWriter                    resultWriter;
+    Tracer                          tracer;
+    std::vector<float_t>            resultValue;
+    std::string                     sampleStreamPath;
+    uint32_t                        sampleStreamWait;
+    int                             sampleStream = -1;
+    std::vector<uint8_t>            sampleBuffer;
+    uint64_t                        numStreamed = 0;
+    bool                            inputValid = false;
+
+    /** Link/Port *************************************************************/
+    Link*                           toRouterLink;
+    Link*                           fromRouterLink;
+    Link*                           memoryLink;
+
+    /** Parameters ************************************************************/
+    std::vector<uint32_t>           tilePerClass;
+    uint32_t                        tileBegin;
+    uint32_t                        tileEnd;
+    uint32_t                        numClass;
+
+    uint32_t                        routerFlitSize;
+    uint32_t                        memWidth;
+    uint32_t                        resultIndex;
+
+    /** Control signal ********************************************************/
+    bool                            busy = false;
+
+    /** Latency ***************************************************************/
+    struct Issue {
+        SimTime_t                   time;
+        uint32_t                    traceId;
+    };
+    std::deque<Issue>               issued;
+    uint32_t                        traceEvery;
+    uint32_t                        numIssued = 0;
+    uint32_t                        issuedTraceId = Tracer::UNTRACED;
+    uint32_t                        numClassDone = 0;
+    uint64_t                        numCompleted = 0;
+    SimTime_t                       lastCompletion = 0;
+
+    /** Statistics ************************************************************/
+    Statistic<uint64_t>*            sampleLatency;
+    Statistic<double_t>*            throughput;
+};
+
+}
+}
+
 #endif
\ No newline at end of file
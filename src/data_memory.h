@@ -0,0 +1,124 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace SST {
+namespace CAMSHAP {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "DataMemory word accesses assume a little-endian host"
+#endif
+
+/**
+* @brief Byte-addressed, little-endian data memory of a controller
+* @details Words are copied whole with memcpy (the host is little-endian like the controller), so no access
+* assembles bytes one by one. Accesses are bounds-checked in debug builds only.
+*/
+class DataMemory {
+public:
+    DataMemory(const std::vector<uint8_t> &_entry, uint32_t size) : entry(_entry) {
+        if (entry.size() < size){
+            entry.resize(size, 0);
+        }
+    }
+
+    uint32_t getINT_4B(uint32_t addr) const {
+        uint32_t value;
+        std::memcpy(&value, word(addr, 4), 4);
+        return value;
+    }
+    float_t getFP_4B(uint32_t addr) const {
+        float_t fp;
+        std::memcpy(&fp, word(addr, 4), 4);
+        return fp;
+    }
+    uint32_t getINT_1B(uint32_t addr) const {
+        return *word(addr, 1);
+    }
+    uint32_t getINT_2B(uint32_t addr) const {
+        uint16_t value;
+        std::memcpy(&value, word(addr, 2), 2);
+        return value;
+    }
+    /** Gather one byte from each of the 4 addresses packed in 'addr', each shifted by 'offset' */
+    uint32_t getINT_1B_4(uint32_t addr, uint32_t offset) const {
+        uint32_t value = (getINT_1B(((addr >> 24) & 0xff)+offset) << 24) + (getINT_1B(((addr >> 16) & 0xff)+offset) << 16) + (getINT_1B(((addr >> 8) & 0xff)+offset) << 8) + getINT_1B((addr & 0xff)+offset);
+        return value;
+    }
+    float_t getFP_1B_4(uint32_t addr, uint32_t offset) const {
+        uint32_t value = getINT_1B_4(addr, offset);
+        float_t fp;
+        std::memcpy(&fp, &value, 4);
+        return fp;
+    }
+    void putFP_4B(uint32_t addr, float_t fp) {
+        std::memcpy(word(addr, 4), &fp, 4);
+    }
+    void putINT_4B(uint32_t addr, uint32_t value) {
+        std::memcpy(word(addr, 4), &value, 4);
+    }
+    void putINT_2B(uint32_t addr, uint16_t value) {
+        std::memcpy(word(addr, 2), &value, 2);
+    }
+    void putINT_1B(uint32_t addr, uint8_t value) {
+        *word(addr, 1) = value;
+    }
+    /** Bulk copy of 'size' bytes to 'addr' */
+    void write(uint32_t addr, const uint8_t *data, uint32_t size) {
+        if (size > 0){
+            std::memcpy(word(addr, size), data, size);
+        }
+    }
+    /** Bulk zero of 'size' bytes at 'addr' */
+    void clear(uint32_t addr, uint32_t size) {
+        if (size > 0){
+            std::memset(word(addr, size), 0, size);
+        }
+    }
+    std::vector<uint8_t>::const_iterator at(uint32_t addr) const {
+        assert(addr <= entry.size());
+        return entry.begin() + addr;
+    }
+    uint32_t size() const { return entry.size(); }
+
+private:
+    const uint8_t* word(uint32_t addr, uint32_t width) const {
+        assert(uint64_t(addr) + width <= entry.size());
+        return entry.data() + addr;
+    }
+    uint8_t* word(uint32_t addr, uint32_t width) {
+        assert(uint64_t(addr) + width <= entry.size());
+        return entry.data() + addr;
+    }
+
+    std::vector<uint8_t> entry;
+};
+
+}
+}
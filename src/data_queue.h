@@ -1,88 +1,196 @@
-// MIT License
-//
-// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-//		
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
-// 
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
-
-#pragma once
-
-#include <sst/core/statapi/statbase.h>
-
-#include <queue>
-#include <cstdint>
-
-namespace SST {
-namespace CAMSHAP {
-
-using namespace Statistics;
-
-template<class T>
-class Queue {
-public:
-    using Entry = std::pair<Cycle_t, T>;
-    Queue()
-    {
-        nextAvailable = 0;
-    }
-
-    void push_out(Cycle_t current, Cycle_t delay, T obj) {
-
-        if (delayQueue.empty()){
-            if (nextAvailable <= current){
-                delayQueue.push(std::make_pair(current + 0, obj));
-                nextAvailable = current + delay;
-            }
-            else{
-                delayQueue.push(std::make_pair(nextAvailable + 0, obj));
-                nextAvailable += delay;
-            }
-        }
-        else{
-            auto back = delayQueue.back();
-            delayQueue.push(std::make_pair(back.first + delay, obj));
-        }
-    }
-
-    void push(Cycle_t current, Cycle_t delay, T obj) {
-        if (delayQueue.empty()){
-            delayQueue.push(std::make_pair(current + delay, obj));
-        }
-        else{
-            auto back = delayQueue.back();
-            delayQueue.push(std::make_pair(back.first + delay, obj));
-        }
-    }
-    
-    T pop(Cycle_t cycle) {
-        T out = nullptr;
-        if(!delayQueue.empty()) {
-            auto entry = delayQueue.front();
-            if(entry.first <= cycle) {
-                delayQueue.pop();
-                out = entry.second;
-            }
-        }
-        return out;
-    }
-    Cycle_t nextAvailable;
-    std::queue<Entry>   delayQueue;
-};
-
-}
-}
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <sst/core/statapi/statbase.h>
+
+#include <deque>
+#include <queue>
+#include <cstdint>
+
+namespace SST {
+namespace CAMSHAP {
+
+using namespace Statistics;
+
+/**
+* @brief Input buffer of a clocked unit: each entry becomes available at its ready cycle, in arrival order
+* @details capacity bounds the buffer (0: unbounded). An SST link cannot refuse an event, so an entry pushed while the
+* queue is full is still kept, but full() tells the owner to hold back its senders and the push is counted as an
+* overflow. Once the owner hands it statistics, the queue records the depth seen by each arriving entry, the cycles
+* each entry waited from arrival to pop, and the overflows; maxDepth is kept for the owner to record at finish.
+*/
+template<class T>
+class Queue {
+public:
+    struct Entry {
+        Cycle_t ready;
+        Cycle_t arrival;
+        T       obj;
+    };
+    Queue(uint32_t capacity = 0) :
+        nextAvailable(0), capacity(capacity), maxDepth(0), depthStat(nullptr), waitStat(nullptr), overflowStat(nullptr)
+    { }
+
+    void setStatistics(Statistic<uint32_t> *depth, Statistic<uint64_t> *wait, Statistic<uint64_t> *overflow) {
+        depthStat       = depth;
+        waitStat        = wait;
+        overflowStat    = overflow;
+    }
+
+    void push_out(Cycle_t current, Cycle_t delay, T obj) {
+
+        if (delayQueue.empty()){
+            if (nextAvailable <= current){
+                enqueue(current, current + 0, obj);
+                nextAvailable = current + delay;
+            }
+            else{
+                enqueue(current, nextAvailable + 0, obj);
+                nextAvailable += delay;
+            }
+        }
+        else{
+            enqueue(current, delayQueue.back().ready + delay, obj);
+        }
+    }
+
+    void push(Cycle_t current, Cycle_t delay, T obj) {
+        if (delayQueue.empty()){
+            enqueue(current, current + delay, obj);
+        }
+        else{
+            enqueue(current, delayQueue.back().ready + delay, obj);
+        }
+    }
+    
+    bool empty() const {
+        return delayQueue.empty();
+    }
+
+    bool full() const {
+        return capacity > 0 && delayQueue.size() >= capacity;
+    }
+
+    uint32_t size() const {
+        return delayQueue.size();
+    }
+
+    uint32_t getMaxDepth() const {
+        return maxDepth;
+    }
+
+    /** The entry that pop would return at 'cycle', left in the queue; nullptr if none is ready */
+    T front(Cycle_t cycle) const {
+        if (delayQueue.empty() || delayQueue.front().ready > cycle){
+            return nullptr;
+        }
+        return delayQueue.front().obj;
+    }
+
+    T pop(Cycle_t cycle) {
+        T out = nullptr;
+        if(!delayQueue.empty()) {
+            const Entry &entry = delayQueue.front();
+            if(entry.ready <= cycle) {
+                if (waitStat){
+                    waitStat->addData(cycle - entry.arrival);
+                }
+                out = entry.obj;
+                delayQueue.pop();
+            }
+        }
+        return out;
+    }
+    Cycle_t nextAvailable;
+    std::queue<Entry>   delayQueue;
+
+private:
+    void enqueue(Cycle_t arrival, Cycle_t ready, T obj) {
+        if (full() && overflowStat){
+            overflowStat->addData(1);
+        }
+        delayQueue.push(Entry{ready, arrival, obj});
+        if (delayQueue.size() > maxDepth){
+            maxDepth = delayQueue.size();
+        }
+        if (depthStat){
+            depthStat->addData(delayQueue.size());
+        }
+    }
+
+    uint32_t                capacity;
+    uint32_t                maxDepth;
+    Statistic<uint32_t>     *depthStat;
+    Statistic<uint64_t>     *waitStat;
+    Statistic<uint64_t>     *overflowStat;
+};
+
+/**
+* @brief Issue slot of a non-pipelined unit without a clock handler
+* @details A request arriving at core time 'now' starts on the next clock edge, or once the previous request has left
+* the unit, and then holds the unit for 'occupancy' cycles. This is the schedule a clocked FIFO with a busy flag
+* produces, computed once per request instead of polled every cycle. Once the owner hands it statistics, the slot
+* records the cycles each request waited from its arrival edge to its start, and the depth seen by each arriving
+* request: the requests still waiting or in service, itself included.
+*/
+class IssueSlot {
+public:
+    IssueSlot() : nextFree(0), depthStat(nullptr), waitStat(nullptr) { }
+
+    void setStatistics(Statistic<uint32_t> *depth, Statistic<uint64_t> *wait) {
+        depthStat       = depth;
+        waitStat        = wait;
+    }
+
+    /** Core-time delay from 'now' to the last cycle of the request */
+    SimTime_t issue(SimTime_t now, SimTime_t period, Cycle_t occupancy) {
+        Cycle_t arrival = now / period + 1;
+        Cycle_t start = arrival;
+        if (start < nextFree){
+            start = nextFree;
+        }
+        nextFree = start + occupancy;
+        if (waitStat){
+            waitStat->addData(start - arrival);
+        }
+        if (depthStat){
+            // Requests leave in order, so those done by the arrival edge are at the front
+            while (!pending.empty() && pending.front() <= arrival){
+                pending.pop_front();
+            }
+            pending.push_back(nextFree);
+            depthStat->addData(pending.size());
+        }
+        return (start + occupancy - 1) * period - now;
+    }
+
+private:
+    Cycle_t                 nextFree;
+    std::deque<Cycle_t>     pending;
+    Statistic<uint32_t>     *depthStat;
+    Statistic<uint64_t>     *waitStat;
+};
+
+}
+}
@@ -0,0 +1,122 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "dma.h"
+
+using namespace SST;
+using namespace SST::CAMSHAP;
+
+/**
+* @brief Main constructor for dma
+* @details Read parameters, configure output and set up the time base. The engine has no clock handler: each
+* descriptor is scheduled on the self link when it is issued.
+*/
+dma::dma(ComponentId_t id, Params &params, DataMemory *memory) : DMAEngine(id, params, memory) {
+    /* Read parameters */
+    uint32_t verbose        = params.find<uint32_t>("verbose", 0);
+    uint32_t mask           = params.find<uint32_t>("mask", 0);
+    std::string name        = params.find<std::string>("name", "dma");
+    UnitAlgebra freq        = params.find<UnitAlgebra>("freq", "1GHz");
+    bandwidth               = params.find<uint32_t>("bandwidth", 16);
+    latency                 = params.find<uint32_t>("latency", 2);
+    numRead                 = 0;
+
+    /* Configure output */
+    std::string outputDir   = params.find<std::string>("outputDir");
+    outFile.init("@t ", verbose, mask, Output::FILE, outputDir+name+".txt");
+    if (bandwidth == 0){
+        outFile.fatal(CALL_INFO, -1, "DMA bandwidth must be at least 1 byte per cycle\n");
+    }
+
+    /* Time base */
+    clockPeriod     = getTimeConverter(freq);
+    coreTime        = getTimeConverter(getCoreTimeBase());
+
+    /* Configure links */
+    selfLink        = configureSelfLink("self", freq, new Event::Handler<dma>(this, &dma::handleSelf));
+
+    /* Register statistics */
+    bytesRead       = registerStatistic<uint32_t>("bytesRead");
+    bytesWritten    = registerStatistic<uint32_t>("bytesWritten");
+    busyCycle       = registerStatistic<uint32_t>("busyCycle");
+}
+
+/**
+ * @brief Issue a read descriptor: the bytes are captured now and handed to 'done' when the transfer completes.
+ */
+void
+dma::read(uint32_t addr, uint32_t size, ReadCallback done){
+    Transfer transfer;
+    transfer.isRead = true;
+    transfer.addr = addr;
+    transfer.data.assign(memory->at(addr), memory->at(addr + size));
+    transfer.readDone = std::move(done);
+    bytesRead->addData(size);
+    numRead++;
+    issue(std::move(transfer));
+}
+
+/**
+ * @brief Issue a write descriptor: 'data' lands in data memory at 'addr' when the transfer completes.
+ */
+void
+dma::write(uint32_t addr, Payload &&data, WriteCallback done){
+    Transfer transfer;
+    transfer.isRead = false;
+    transfer.addr = addr;
+    transfer.data = std::move(data);
+    transfer.writeDone = std::move(done);
+    bytesWritten->addData(transfer.data.size());
+    issue(std::move(transfer));
+}
+
+void
+dma::issue(Transfer &&transfer){
+    Cycle_t occupancy = (transfer.data.size() + bandwidth - 1) / bandwidth;
+    if (occupancy == 0){
+        occupancy = 1;
+    }
+    busyCycle->addData(occupancy);
+    CAMSHAP_VERBOSE(outFile, 4, (1<<11), "%10s - Addr:%8" PRIu32 ", Size:%8zu\n", transfer.isRead ? "Read" : "Write", transfer.addr, transfer.data.size());
+    SimTime_t now = getCurrentSimCycle();
+    SimTime_t delay = issueSlot.issue(now, clockPeriod->getFactor(), occupancy) + latency * clockPeriod->getFactor();
+    inFlight.push_back(std::move(transfer));
+    selfLink->send(delay, coreTime, new CAMSHAPCoreEvent(static_cast<uint32_t>(Instrn::COPY), 0, 0, Payload()));
+}
+
+/**
+ * @brief Complete the oldest transfer: write its bytes or hand them to the controller, then run its callback.
+ */
+void
+dma::handleSelf(Event *ev){
+    Transfer transfer = std::move(inFlight.front());
+    inFlight.pop_front();
+    if (transfer.isRead){
+        numRead--;
+        transfer.readDone(std::move(transfer.data));
+    }
+    else{
+        memory->write(transfer.addr, transfer.data.begin(), transfer.data.size());
+        transfer.writeDone();
+    }
+    delete ev;
+}
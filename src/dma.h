@@ -0,0 +1,147 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef _DMA_SUBCOMPONENT_H
+#define _DMA_SUBCOMPONENT_H
+
+#include "event.h"
+#include "data_memory.h"
+#include "data_queue.h"
+#include "verbose.h"
+
+#include <sst/core/subcomponent.h>
+#include <sst/core/link.h>
+#include <sst/core/timeConverter.h>
+#include <sst/core/output.h>
+#include <sst/core/unitAlgebra.h>
+
+#include <deque>
+#include <functional>
+
+namespace SST {
+namespace CAMSHAP {
+
+/**
+* @brief Interface of the DMA engine of a controller (subcomponent slot "dma")
+* @details The controller issues COPY descriptors and the engine moves the bytes while the pipeline keeps running.
+* read() captures [addr, addr+size) at issue, so the buffer can be reused right away, and hands the payload to 'done'
+* once it has been transferred. write() copies a received payload into data memory and then calls 'done', which
+* raises the mailbox flag of the controller.
+*/
+class DMAEngine : public SST::SubComponent {
+public:
+    SST_ELI_REGISTER_SUBCOMPONENT_API(SST::CAMSHAP::DMAEngine, DataMemory*)
+
+    typedef std::function<void(Payload&&)>  ReadCallback;
+    typedef std::function<void()>           WriteCallback;
+
+    DMAEngine(ComponentId_t id, Params& params, DataMemory *memory) : SubComponent(id), memory(memory) { }
+    virtual ~DMAEngine() { }
+
+    virtual void read(uint32_t addr, uint32_t size, ReadCallback done) = 0;
+    virtual void write(uint32_t addr, Payload &&data, WriteCallback done) = 0;
+    /** True while a read has not been handed to its callback: a later CUSTOM must not overtake it */
+    virtual bool readPending() const = 0;
+
+protected:
+    DataMemory                      *memory;
+};
+
+/**
+* @brief DMA engine with one channel of 'bandwidth' bytes per cycle and a fixed 'latency'
+* @details Descriptors are served in issue order. A descriptor holds the channel for ceil(size/bandwidth) cycles and
+* completes 'latency' cycles after it leaves the channel, so completions also come back in issue order.
+*/
+class dma : public DMAEngine {
+public:
+    SST_ELI_REGISTER_SUBCOMPONENT(
+        dma,
+        "camshap",
+        "dma",
+        SST_ELI_ELEMENT_VERSION(1,0,0),
+        "DMA engine for COPY transfers of a controller",
+        SST::CAMSHAP::DMAEngine
+    )
+    SST_ELI_DOCUMENT_PARAMS(
+        {"verbose",             "(uint) Output verbosity. The higher verbosity, the more debug info", "0"},
+        {"mask",                "(uint) Output mask", "0"},
+        {"name",                "(string) Name of component"},
+        {"freq",                "(UnitAlgebra) Clock frequency", "1GHz"},
+        {"bandwidth",           "(uint) Bytes moved per cycle", "16"},
+        {"latency",             "(uint) Cycles from the end of a transfer to its completion", "2"},
+        {"outputDir",           "(string) Path of output files", " "},
+    )
+    SST_ELI_DOCUMENT_STATISTICS(
+        { "bytesRead",          "Bytes read from data memory", "bytes", 1},
+        { "bytesWritten",       "Bytes written to data memory", "bytes", 1},
+        { "busyCycle",          "Cycles the channel is busy", "cycles", 1},
+    )
+
+    dma(ComponentId_t id, Params& params, DataMemory *memory);
+    ~dma() { }
+
+    void read(uint32_t addr, uint32_t size, ReadCallback done) override;
+    void write(uint32_t addr, Payload &&data, WriteCallback done) override;
+    bool readPending() const override { return numRead > 0; }
+
+    void handleSelf( SST::Event* ev );
+
+private:
+    struct Transfer {
+        bool            isRead;
+        uint32_t        addr;
+        Payload         data;
+        ReadCallback    readDone;
+        WriteCallback   writeDone;
+    };
+    void issue(Transfer &&transfer);
+
+    /** Clock *****************************************************************/
+    TimeConverter                   *clockPeriod;
+    TimeConverter                   *coreTime;
+    IssueSlot                       issueSlot;
+
+    /** IO ********************************************************************/
+    Output                          outFile;
+
+    /** Link/Port *************************************************************/
+    Link*                           selfLink;
+
+    /** Parameters ************************************************************/
+    uint32_t                        bandwidth;
+    uint32_t                        latency;
+
+    /** Transfers in flight, oldest first *************************************/
+    std::deque<Transfer>            inFlight;
+    uint32_t                        numRead;
+
+    /** Statistics ************************************************************/
+    Statistic<uint32_t>*            bytesRead;
+    Statistic<uint32_t>*            bytesWritten;
+    Statistic<uint32_t>*            busyCycle;
+};
+
+}
+}
+
+#endif
@@ -1,112 +1,212 @@
-// MIT License
-//
-// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-//		
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
-// 
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
-
-#pragma once
-
-#include <sst/core/event.h>
-
-#include <cstdint>
-#include <string>
-
-#include "instruction.h"
-
-namespace SST {
-namespace CAMSHAP {
-
-class CAMSHAPEvent : public Event {
-
-public:
-    void serialize_order(SST::Core::Serialization::serializer &ser)  override {
-        Event::serialize_order(ser);
-        ser & opcode;
-        ser & dst;
-        ser & src1;
-        ser & src2;
-        ser & imm;
-        ser & payload;
-    }    
-
-    CAMSHAPEvent(uint32_t _opcode, uint32_t _dst, uint32_t _src1, uint32_t _src2, uint32_t _imm, std::vector<uint8_t> _payload) :
-        Event(), opcode(_opcode), dst(_dst), src1(_src1), src2(_src2), imm(_imm), payload(_payload) { }
-
-    CAMSHAPEvent *clone() override {
-        return new CAMSHAPEvent(*this);
-    }
-
-    uint32_t getOpcode() const { return opcode;}
-    uint32_t getDst() const { return dst;}
-    uint32_t getSrc1() const { return src1;}
-    uint32_t getSrc2() const { return src2;}
-    uint32_t getImm() const { return imm;}
-    std::vector<uint8_t>& getPayload() { return payload; }
-
-private:
-    CAMSHAPEvent()  {} // For Serialization only
-    uint32_t opcode;
-    uint32_t dst;
-    uint32_t src1;
-    uint32_t src2;
-    uint32_t imm;
-    std::vector<uint8_t> payload;
-
-    ImplementSerializable(SST::CAMSHAP::CAMSHAPEvent);
-};
-
-class CAMSHAPCoreEvent : public Event {
-
-public:
-    void serialize_order(SST::Core::Serialization::serializer &ser)  override {
-        Event::serialize_order(ser);
-        ser & opcode;
-        ser & dst;
-        ser & imm;
-        ser & payload;
-    }    
-
-    /**
-    * @brief 
-    */
-    CAMSHAPCoreEvent(uint32_t _opcode, uint32_t _dst, uint32_t _imm, std::vector<uint8_t> _payload) :
-        Event(), opcode(_opcode), dst(_dst), imm(_imm), payload(_payload){ }
-
-    CAMSHAPCoreEvent *clone() override {
-        return new CAMSHAPCoreEvent(*this);
-    }
-
-    uint32_t getOpcode() const { return opcode;}
-    uint32_t getDst() const { return dst;}
-    uint32_t getImm() const { return imm;}
-    std::vector<uint8_t>& getPayload() { return payload; }
-
-private:
-    CAMSHAPCoreEvent()  {} // For Serialization only
-    uint32_t opcode;
-    uint32_t dst;
-    uint32_t imm;
-    std::vector<uint8_t> payload;
-
-    ImplementSerializable(SST::CAMSHAP::CAMSHAPCoreEvent);
-};
-
-
-}
-}
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <sst/core/event.h>
+
+#include <cstdint>
+#include <string>
+
+#include "instruction.h"
+#include "event_pool.h"
+#include "payload.h"
+#include "trace.h"
+#include "wire_codec.h"
+
+namespace SST {
+namespace CAMSHAP {
+
+class CAMSHAPEvent : public Event {
+
+public:
+    void serialize_order(SST::Core::Serialization::serializer &ser)  override {
+        Event::serialize_order(ser);
+        static thread_local std::vector<uint8_t> wire;
+        wire.clear();
+        if (ser.mode() != SST::Core::Serialization::serializer::UNPACK){
+            encode(wire);
+        }
+        ser & wire;
+        if (ser.mode() == SST::Core::Serialization::serializer::UNPACK){
+            decode(wire);
+        }
+    }    
+
+    /**
+    * @brief Compact encoding used for serialization
+    * @details varint(opcode), a flag byte with one bit per non-default field, the non-default fields as varints, then the payload.
+    * Data events only carry their tile range and results only carry their class (imm), so most fields are dropped.
+    * Only events of a traced sample carry a trace id.
+    */
+    void encode(std::vector<uint8_t> &wire) const {
+        bool hasRange = (tileBegin != 0) || (tileEnd != UINT32_MAX);
+        bool hasTrace = (traceId != Tracer::UNTRACED);
+        uint8_t flags = (dst != 0) | ((src1 != 0) << 1) | ((src2 != 0) << 2) | ((imm != 0) << 3) | (hasRange << 4) | (hasTrace << 5);
+        WireCodec::putVarint(wire, opcode);
+        wire.push_back(flags);
+        if (flags & (1<<0)) WireCodec::putVarint(wire, dst);
+        if (flags & (1<<1)) WireCodec::putVarint(wire, src1);
+        if (flags & (1<<2)) WireCodec::putVarint(wire, src2);
+        if (flags & (1<<3)) WireCodec::putVarint(wire, imm);
+        if (flags & (1<<4)){
+            WireCodec::putVarint(wire, tileBegin);
+            WireCodec::putVarint(wire, tileEnd - tileBegin);
+        }
+        if (flags & (1<<5)) WireCodec::putVarint(wire, traceId);
+        WireCodec::putPayload(wire, payload);
+    }
+
+    void decode(const std::vector<uint8_t> &wire) {
+        std::size_t pos = 0;
+        opcode  = WireCodec::getVarint(wire, pos);
+        uint8_t flags = wire[pos++];
+        dst     = (flags & (1<<0)) ? WireCodec::getVarint(wire, pos) : 0;
+        src1    = (flags & (1<<1)) ? WireCodec::getVarint(wire, pos) : 0;
+        src2    = (flags & (1<<2)) ? WireCodec::getVarint(wire, pos) : 0;
+        imm     = (flags & (1<<3)) ? WireCodec::getVarint(wire, pos) : 0;
+        tileBegin   = 0;
+        tileEnd     = UINT32_MAX;
+        if (flags & (1<<4)){
+            tileBegin   = WireCodec::getVarint(wire, pos);
+            tileEnd     = tileBegin + WireCodec::getVarint(wire, pos);
+        }
+        traceId = (flags & (1<<5)) ? WireCodec::getVarint(wire, pos) : Tracer::UNTRACED;
+        WireCodec::getPayload(wire, pos, payload);
+    }
+
+    /** Bytes this event takes on a link crossing ranks */
+    uint32_t getWireSize() const {
+        static thread_local std::vector<uint8_t> wire;
+        wire.clear();
+        encode(wire);
+        return wire.size();
+    }
+
+    /**
+    * @brief Event between control units and routers
+    * @details [_tileBegin, _tileEnd] is the range of destination tiles. Routers forward the event only to the ports covering it.
+    * The payload is moved in.
+    */
+    CAMSHAPEvent(uint32_t _opcode, uint32_t _dst, uint32_t _src1, uint32_t _src2, uint32_t _imm, Payload &&_payload, uint32_t _tileBegin = 0, uint32_t _tileEnd = UINT32_MAX) :
+        Event(), opcode(_opcode), dst(_dst), src1(_src1), src2(_src2), imm(_imm), tileBegin(_tileBegin), tileEnd(_tileEnd), traceId(Tracer::UNTRACED), payload(std::move(_payload)) { }
+
+    CAMSHAPEvent(const CAMSHAPEvent &ev) :
+        Event(ev), opcode(ev.opcode), dst(ev.dst), src1(ev.src1), src2(ev.src2), imm(ev.imm), tileBegin(ev.tileBegin), tileEnd(ev.tileEnd), traceId(ev.traceId), payload(ev.payload) { }
+
+    static void* operator new(std::size_t size) { return EventPool<CAMSHAPEvent>::allocate(size); }
+    static void operator delete(void *ptr, std::size_t size) { EventPool<CAMSHAPEvent>::deallocate(ptr, size); }
+
+    CAMSHAPEvent *clone() override {
+        return new CAMSHAPEvent(*this);
+    }
+
+    uint32_t getOpcode() const { return opcode;}
+    uint32_t getDst() const { return dst;}
+    uint32_t getSrc1() const { return src1;}
+    uint32_t getSrc2() const { return src2;}
+    uint32_t getImm() const { return imm;}
+    uint32_t getTileBegin() const { return tileBegin;}
+    uint32_t getTileEnd() const { return tileEnd;}
+    bool isForTile(uint32_t first, uint32_t last) const { return (first <= tileEnd) && (tileBegin <= last); }
+    uint32_t getTraceId() const { return traceId;}
+    CAMSHAPEvent* setTraceId(uint32_t _traceId) { traceId = _traceId; return this; }
+    Payload& getPayload() { return payload; }
+
+private:
+    CAMSHAPEvent()  {} // For Serialization only
+    uint32_t opcode;
+    uint32_t dst;
+    uint32_t src1;
+    uint32_t src2;
+    uint32_t imm;
+    uint32_t tileBegin;
+    uint32_t tileEnd;
+    uint32_t traceId;
+    Payload payload;
+
+    ImplementSerializable(SST::CAMSHAP::CAMSHAPEvent);
+};
+
+class CAMSHAPCoreEvent : public Event {
+
+public:
+    void serialize_order(SST::Core::Serialization::serializer &ser)  override {
+        Event::serialize_order(ser);
+        static thread_local std::vector<uint8_t> wire;
+        wire.clear();
+        if (ser.mode() != SST::Core::Serialization::serializer::UNPACK){
+            WireCodec::putVarint(wire, opcode);
+            WireCodec::putVarint(wire, dst);
+            WireCodec::putVarint(wire, imm);
+            WireCodec::putVarint(wire, traceId + 1); // UNTRACED wraps to 0, a single byte
+            WireCodec::putPayload(wire, payload);
+        }
+        ser & wire;
+        if (ser.mode() == SST::Core::Serialization::serializer::UNPACK){
+            std::size_t pos = 0;
+            opcode  = WireCodec::getVarint(wire, pos);
+            dst     = WireCodec::getVarint(wire, pos);
+            imm     = WireCodec::getVarint(wire, pos);
+            traceId = WireCodec::getVarint(wire, pos) - 1;
+            WireCodec::getPayload(wire, pos, payload);
+        }
+    }    
+
+    /**
+    * @brief Event between control_core and acam/mpe/mmr
+    * @details The payload is moved in.
+    */
+    CAMSHAPCoreEvent(uint32_t _opcode, uint32_t _dst, uint32_t _imm, Payload &&_payload) :
+        Event(), opcode(_opcode), dst(_dst), imm(_imm), traceId(Tracer::UNTRACED), payload(std::move(_payload)) { }
+
+    CAMSHAPCoreEvent(const CAMSHAPCoreEvent &ev) :
+        Event(ev), opcode(ev.opcode), dst(ev.dst), imm(ev.imm), traceId(ev.traceId), payload(ev.payload) { }
+
+    static void* operator new(std::size_t size) { return EventPool<CAMSHAPCoreEvent>::allocate(size); }
+    static void operator delete(void *ptr, std::size_t size) { EventPool<CAMSHAPCoreEvent>::deallocate(ptr, size); }
+
+    CAMSHAPCoreEvent *clone() override {
+        return new CAMSHAPCoreEvent(*this);
+    }
+
+    uint32_t getOpcode() const { return opcode;}
+    uint32_t getDst() const { return dst;}
+    uint32_t getImm() const { return imm;}
+    uint32_t getTraceId() const { return traceId;}
+    CAMSHAPCoreEvent* setTraceId(uint32_t _traceId) { traceId = _traceId; return this; }
+    Payload& getPayload() { return payload; }
+
+private:
+    CAMSHAPCoreEvent()  {} // For Serialization only
+    uint32_t opcode;
+    uint32_t dst;
+    uint32_t imm;
+    uint32_t traceId;
+    Payload payload;
+
+    ImplementSerializable(SST::CAMSHAP::CAMSHAPCoreEvent);
+};
+
+
+}
+}
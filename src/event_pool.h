@@ -0,0 +1,147 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace SST {
+namespace CAMSHAP {
+
+/**
+* @brief Per-thread free list of fixed-size blocks for event objects.
+* @details Used by operator new/delete of an event class, so that SST can still delete events on receive.
+* A block freed on another thread goes to that thread's list. The list is a plain pointer chain (no destructor),
+* so events deleted during static destruction are still safe.
+*/
+template<class T>
+class EventPool {
+public:
+    static const uint32_t MAX_FREE = 1 << 16;
+
+    static void* allocate(std::size_t size) {
+        if (size != sizeof(T) || !head){
+            return ::operator new(size < sizeof(Block) ? sizeof(Block) : size);
+        }
+        Block *block = head;
+        head = block->next;
+        numFree--;
+        return block;
+    }
+
+    static void deallocate(void *ptr, std::size_t size) {
+        if (!ptr){
+            return;
+        }
+        if (size != sizeof(T) || numFree >= MAX_FREE){
+            ::operator delete(ptr);
+            return;
+        }
+        Block *block = static_cast<Block*>(ptr);
+        block->next = head;
+        head = block;
+        numFree++;
+    }
+
+private:
+    struct Block {
+        Block *next;
+    };
+    static thread_local Block       *head;
+    static thread_local uint32_t    numFree;
+};
+
+template<class T>
+thread_local typename EventPool<T>::Block *EventPool<T>::head = nullptr;
+
+template<class T>
+thread_local uint32_t EventPool<T>::numFree = 0;
+
+/**
+* @brief Per-thread pool of payload buffers, binned by power-of-two capacity.
+* @details Events give their payload buffer back on destruction, and the next event of a similar size reuses it.
+*/
+class PayloadPool {
+public:
+    static const uint32_t NUM_BIN = 16;
+    static const uint32_t MAX_FREE = 1024;
+
+    static std::vector<uint8_t> acquire(std::size_t size) {
+        std::vector<uint8_t> buffer;
+        if (size == 0){
+            return buffer;
+        }
+        uint32_t bin = binOf(size, true);
+        std::vector<std::vector<uint8_t>> *bins = getBins();
+        if (bin < NUM_BIN && bins && !bins[bin].empty()){
+            buffer.swap(bins[bin].back());
+            bins[bin].pop_back();
+        }
+        else if (bin < NUM_BIN){
+            buffer.reserve(std::size_t(1) << bin);
+        }
+        return buffer;
+    }
+
+    static void release(std::vector<uint8_t> &buffer) {
+        if (buffer.capacity() == 0){
+            return;
+        }
+        uint32_t bin = binOf(buffer.capacity(), false);
+        if (bin >= NUM_BIN){
+            return;
+        }
+        std::vector<std::vector<uint8_t>> *&bins = getBins();
+        if (!bins){
+            // Intentionally never freed: buffers may be released during static destruction.
+            bins = new std::vector<std::vector<uint8_t>>[NUM_BIN];
+        }
+        if (bins[bin].size() < MAX_FREE){
+            buffer.clear();
+            bins[bin].emplace_back();
+            bins[bin].back().swap(buffer);
+        }
+    }
+
+private:
+    /** Smallest bin holding 'size' bytes (roundUp) or largest bin not exceeding 'size' bytes */
+    static uint32_t binOf(std::size_t size, bool roundUp) {
+        uint32_t bin = 0;
+        while ((std::size_t(1) << bin) < size){
+            bin++;
+        }
+        if (!roundUp && (std::size_t(1) << bin) > size){
+            bin--;
+        }
+        return bin;
+    }
+    static std::vector<std::vector<uint8_t>> *&getBins() {
+        static thread_local std::vector<std::vector<uint8_t>> *bins = nullptr;
+        return bins;
+    }
+};
+
+}
+}
@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace SST {
+namespace CAMSHAP {
+
+/**
+* @brief Low-precision formats of packed operands, selected by funct7 of OP_V
+* @details E4M3 is the encoding the controllers have always used: bias 7, no NaN, subnormals below exponent 1.
+* E5M2, FP16 and BF16 follow IEEE 754 conventions.
+*/
+enum class FPFormat : uint8_t {
+    E4M3    = 0,
+    FP16    = 1,
+    E5M2    = 2,
+    BF16    = 3
+};
+
+/**
+* @brief Table-driven decoder of low-precision formats to FP32
+* @details 8-bit formats are looked up in a 256-entry table built once per process. FP16 and BF16 are widened with
+* bit operations, so no decode calls std::pow.
+*/
+class FPDecoder {
+public:
+    static const uint32_t NUM_FORMAT = 4;
+
+    static bool valid(uint32_t format) { return format < NUM_FORMAT; }
+
+    /** Bytes per element */
+    static uint32_t width(uint32_t format) {
+        return (format == uint32_t(FPFormat::FP16) || format == uint32_t(FPFormat::BF16)) ? 2 : 1;
+    }
+
+    static float decode(uint32_t raw, uint32_t format) {
+        switch (FPFormat(format)){
+            case FPFormat::E4M3:
+                return tableE4M3().value[raw & 0xff];
+            case FPFormat::E5M2:
+                return tableE5M2().value[raw & 0xff];
+            case FPFormat::FP16:
+                return decodeFP16(raw & 0xffff);
+            case FPFormat::BF16:
+                return fromBits((raw & 0xffff) << 16);
+            default:
+                return 0.0f;
+        }
+    }
+
+private:
+    struct Table {
+        float value[256];
+    };
+
+    /** exponentBit/mantissaBit/bias of an 8-bit format; inf and NaN only if the top exponent is reserved */
+    static Table build(uint32_t exponentBit, uint32_t mantissaBit, int32_t bias, bool reserveTop) {
+        Table table;
+        uint32_t exponentMax = (1u << exponentBit) - 1;
+        for (uint32_t i = 0; i < 256; i++){
+            uint32_t sign = i >> 7;
+            uint32_t exponent = (i >> mantissaBit) & exponentMax;
+            uint32_t mantissa = i & ((1u << mantissaBit) - 1);
+            float value;
+            if (reserveTop && exponent == exponentMax){
+                value = mantissa ? NAN : INFINITY;
+            }
+            else if (exponent == 0){
+                value = std::ldexp(float(mantissa), 1 - bias - int32_t(mantissaBit));
+            }
+            else{
+                value = std::ldexp(float(mantissa | (1u << mantissaBit)), int32_t(exponent) - bias - int32_t(mantissaBit));
+            }
+            table.value[i] = sign ? -value : value;
+        }
+        return table;
+    }
+    static const Table& tableE4M3() {
+        static const Table table = build(4, 3, 7, false);
+        return table;
+    }
+    static const Table& tableE5M2() {
+        static const Table table = build(5, 2, 15, true);
+        return table;
+    }
+
+    static float fromBits(uint32_t bits) {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    static float decodeFP16(uint32_t fp16) {
+        uint32_t sign = (fp16 & 0x8000) << 16;
+        uint32_t exponent = (fp16 >> 10) & 0x1f;
+        uint32_t mantissa = fp16 & 0x3ff;
+        if (exponent == 0){
+            // Subnormal: mantissa * 2^-24 is exact in FP32
+            float value = float(mantissa) * (1.0f / 16777216.0f);
+            return sign ? -value : value;
+        }
+        if (exponent == 0x1f){
+            return fromBits(sign | 0x7f800000 | (mantissa << 13));
+        }
+        return fromBits(sign | ((exponent + 112) << 23) | (mantissa << 13));
+    }
+};
+
+}
+}
@@ -1,46 +1,58 @@
-// MIT License
-//
-// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-//		
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
-// 
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
-
-#ifndef _INSTRUCTION_H
-#define _INSTRUCTION_H
-
-namespace SST { 
-namespace CAMSHAP {
-
-enum class Instrn {
-    COPY    = 11,
-    LOAD    = 3,
-    LOAD_FP = 7,
-    OP_IMM  = 19,
-    STORE   = 35,
-    STORE_FP= 39,
-    OP      = 51,
-    LUI     = 55,
-    OP_FP   = 83,
-    BRANCH  = 99,
-    RET     = 0,
-    CUSTOM  = 43
-};
-
-}
-}
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _INSTRUCTION_H
+#define _INSTRUCTION_H
+
+#include <cstdint>
+
+namespace SST { 
+namespace CAMSHAP {
+
+enum class Instrn : uint8_t {
+    COPY    = 11,
+    LOAD    = 3,
+    LOAD_FP = 7,
+    OP_IMM  = 19,
+    STORE   = 35,
+    STORE_FP= 39,
+    OP      = 51,
+    LUI     = 55,
+    OP_FP   = 83,
+    BRANCH  = 99,
+    RET     = 0,
+    CUSTOM  = 43,
+    OP_V    = 87,
+    LOOP    = 91
+};
+
+/** Register file written by an instruction */
+enum class RegFile : uint8_t {
+    NONE,
+    INT,
+    FP,
+    VEC
+};
+
+}
+}
 #endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <sst/core/output.h>
+#include <sst/core/params.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace SST {
+namespace CAMSHAP {
+
+/**
+* @brief Named region [base, base+size) of a controller data memory
+*/
+struct MemoryRegion {
+    std::string name;
+    uint32_t    base;
+    uint32_t    size;
+
+    uint32_t end() const { return base + size; }
+};
+
+/**
+* @brief Mailboxes and buffers of a controller data memory, indexed by the region enum of the controller
+* @details The controller declares its regions with their default placement. "memoryMap.<name>" = [base, size]
+* overrides a region and "memorySize" the total size of the data memory, so that buffers can be moved or grown
+* from sw.json without editing the controller.
+*/
+class MemoryMap {
+public:
+    MemoryMap() : size(0) { }
+    MemoryMap(std::initializer_list<MemoryRegion> _region) : region(_region), size(0) { }
+
+    /**
+     * @brief Apply the overrides of 'params' and return the data memory size: at least 'minSize' and the end of every region.
+     */
+    uint32_t configure(const Params &params, uint32_t minSize, Output &out) {
+        for (uint32_t i = 0; i < region.size(); i++){
+            std::vector<uint32_t> value;
+            params.find_array<uint32_t>("memoryMap."+region[i].name, value);
+            if (value.empty()){
+                continue;
+            }
+            if (value.size() != 2){
+                out.fatal(CALL_INFO, -1, "memoryMap.%s must be [base, size]\n", region[i].name.c_str());
+            }
+            region[i].base = value[0];
+            region[i].size = value[1];
+        }
+        for (uint32_t i = 0; i < region.size(); i++){
+            if (uint64_t(region[i].base) + region[i].size > UINT32_MAX){
+                out.fatal(CALL_INFO, -1, "memoryMap.%s [%" PRIu32 ", %" PRIu32 "] exceeds the 32-bit address space\n", region[i].name.c_str(), region[i].base, region[i].size);
+            }
+        }
+        size = std::max(minSize, params.find<uint32_t>("memorySize", 0));
+        for (uint32_t i = 0; i < region.size(); i++){
+            size = std::max(size, region[i].end());
+        }
+        return size;
+    }
+
+    const MemoryRegion& operator[](uint32_t id) const { return region[id]; }
+    uint32_t base(uint32_t id) const { return region[id].base; }
+    uint32_t getSize() const { return size; }
+
+private:
+    std::vector<MemoryRegion>   region;
+    uint32_t                    size;
+};
+
+}
+}
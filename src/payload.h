@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "event_pool.h"
+
+namespace SST {
+namespace CAMSHAP {
+
+/**
+* @brief Byte payload of events with inline storage for short payloads.
+* @details Up to INLINE_SIZE bytes live inside the object (CUSTOM requests, FP32 partial sums, MMR output).
+* Larger payloads (match rows, samples) spill to a heap buffer taken from PayloadPool, which goes back to the pool on destruction.
+*/
+class Payload {
+public:
+    static const uint32_t INLINE_SIZE = 32;
+
+    typedef uint8_t*        iterator;
+    typedef const uint8_t*  const_iterator;
+
+    Payload() : length(0) { }
+    Payload(std::size_t n, uint8_t value) : length(0) { assign(n, value); }
+    template<class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    Payload(InputIt first, InputIt last) : length(0) { assign(first, last); }
+    Payload(const Payload &other) : length(0) { assign(other.begin(), other.end()); }
+    Payload(Payload &&other) : length(0) { *this = std::move(other); }
+    ~Payload() { PayloadPool::release(heap); }
+
+    Payload& operator=(const Payload &other) {
+        if (this != &other){
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    Payload& operator=(Payload &&other) {
+        if (this != &other){
+            // The spilled buffers are exchanged; ours is recycled when 'other' dies
+            heap.swap(other.heap);
+            if (other.length <= INLINE_SIZE){
+                std::memcpy(local, other.local, other.length);
+            }
+            length = other.length;
+            other.clear();
+        }
+        return *this;
+    }
+
+    std::size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    uint8_t* data() { return length > INLINE_SIZE ? heap.data() : local; }
+    const uint8_t* data() const { return length > INLINE_SIZE ? heap.data() : local; }
+    iterator begin() { return data(); }
+    iterator end() { return data() + length; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + length; }
+    uint8_t& operator[](std::size_t i) { return data()[i]; }
+    const uint8_t& operator[](std::size_t i) const { return data()[i]; }
+
+    void clear() {
+        heap.clear();
+        length = 0;
+    }
+
+    /** Make room for n bytes without further allocation */
+    void reserve(std::size_t n) {
+        if (n <= INLINE_SIZE || heap.capacity() >= n){
+            return;
+        }
+        std::vector<uint8_t> buffer = PayloadPool::acquire(n);
+        buffer.assign(heap.begin(), heap.end());
+        heap.swap(buffer);
+        PayloadPool::release(buffer);
+    }
+
+    void resize(std::size_t n, uint8_t value = 0) {
+        if (n <= INLINE_SIZE){
+            if (length > INLINE_SIZE){
+                std::memcpy(local, heap.data(), n);
+                heap.clear();
+            }
+            else if (n > length){
+                std::memset(local + length, value, n - length);
+            }
+        }
+        else{
+            reserve(n);
+            if (length <= INLINE_SIZE){
+                heap.assign(local, local + length);
+            }
+            heap.resize(n, value);
+        }
+        length = n;
+    }
+
+    void assign(std::size_t n, uint8_t value) {
+        clear();
+        resize(n, value);
+    }
+
+    template<class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        append(first, last);
+    }
+
+    /** Append [first, last) at the end. The range must not point into this payload. */
+    template<class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    void append(InputIt first, InputIt last) {
+        std::size_t offset = length;
+        resize(length + std::distance(first, last));
+        std::copy(first, last, begin() + offset);
+    }
+
+    void push_back(uint8_t value) { resize(length + 1, value); }
+
+    /** Hand the bytes over to 'dst'. A spilled buffer is swapped in, so no copy is made for large payloads. */
+    void moveTo(std::vector<uint8_t> &dst) {
+        if (length > INLINE_SIZE){
+            dst.swap(heap);
+        }
+        else{
+            dst.assign(local, local + length);
+        }
+        clear();
+    }
+
+private:
+    std::size_t             length;
+    uint8_t                 local[INLINE_SIZE];
+    std::vector<uint8_t>    heap;
+};
+
+}
+}
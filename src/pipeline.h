@@ -0,0 +1,1511 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <sst/core/output.h>
+#include <sst/core/params.h>
+#include <sst/core/statapi/statbase.h>
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "data_memory.h"
+#include "dma.h"
+#include "fp_format.h"
+#include "instruction.h"
+#include "memory_map.h"
+#include "verbose.h"
+
+namespace SST {
+namespace CAMSHAP {
+
+using namespace Statistics;
+
+/**
+* @brief Reason why Decode issued nothing in a cycle, counted by the stallCycle statistic (subId: name)
+* @details HAZARD waits for a load result, COPY for an earlier COPY read still in Execute or the DMA engine, FLUSH is
+* the bubble of a taken branch. POLL takes over HAZARD and FLUSH in a spin on a mailbox that has not changed: the wait
+* for a load re-reading it unchanged, and the flush of the branch back after such a read. Each stalled cycle is counted
+* under exactly one reason. MPE and MMR wait for the response of a CUSTOM request, CAM for a search result to reach the
+* unit that reads it.
+*/
+enum StallReason : uint32_t { STALL_NONE, STALL_HAZARD, STALL_COPY, STALL_FLUSH, STALL_POLL, STALL_MPE, STALL_MMR, STALL_CAM, NUM_STALL };
+
+inline const char* stallName(uint32_t reason) {
+    static const char* name[NUM_STALL] = {"none", "hazard", "copy", "flush", "poll", "mpe", "mmr", "cam"};
+    return name[reason];
+}
+
+/**
+* @brief One predecoded entry of instruction memory
+* @details Built once from the instruction table (7 fields per instruction). The command is resolved from the
+* opcode at load time, and register/function fields are narrowed to bytes so that entries stay contiguous and compact.
+*/
+class InstructionEntry {
+public:
+    static const uint32_t INSTRUCTION_FIELD = 7;
+
+    InstructionEntry(uint32_t _opcode, uint32_t _rd, uint32_t _rs1, uint32_t _rs2, uint32_t _imm, uint32_t _funct3, uint32_t _funct7):
+    imm(_imm), cmd(decodeOpcode(_opcode)), dst(destinationOf(cmd, _funct3)), opcode(_opcode), rd(_rd), rs1(_rs1), rs2(_rs2), funct3(_funct3), funct7(_funct7) { }
+
+    uint32_t getOpcode() const { return opcode;}
+    uint32_t getRd() const { return rd;}
+    uint32_t getRs1() const { return rs1;}
+    uint32_t getRs2() const { return rs2;}
+    uint32_t getImm() const { return imm;}
+    uint32_t getFunct3() const { return funct3;}
+    uint32_t getFunct7() const { return funct7;}
+    Instrn getCmd() const { return cmd;}
+    RegFile getDst() const { return dst;}
+
+    /** True if every field of the table row fits its compact width */
+    static bool fits(uint32_t _opcode, uint32_t _rd, uint32_t _rs1, uint32_t _rs2, uint32_t _funct3, uint32_t _funct7) {
+        return _opcode < 128 && _rd < 32 && _rs1 < 32 && _rs2 < 32 && _funct3 < 8 && _funct7 < 128;
+    }
+
+    static Instrn decodeOpcode(uint32_t _opcode) {
+        switch(_opcode){
+            case(0):
+                return Instrn::RET;
+            case(11):
+                return Instrn::COPY;
+            case(3):
+                return Instrn::LOAD;
+            case(7):
+                return Instrn::LOAD_FP;
+            case(19):
+                return Instrn::OP_IMM;
+            case(35):
+                return Instrn::STORE;
+            case(39):
+                return Instrn::STORE_FP;
+            case(51):
+                return Instrn::OP;
+            case(55):
+                return Instrn::LUI;
+            case(83):
+                return Instrn::OP_FP;
+            case(99):
+                return Instrn::BRANCH;
+            case(43):
+                return Instrn::CUSTOM;
+            case(87):
+                return Instrn::OP_V;
+            case(91):
+                return Instrn::LOOP;
+            default:
+                return Instrn::RET;
+        }
+    }
+
+    /** True if the opcode names an instruction. Each Instrn equals its opcode, so an unknown one decodes to a mismatch */
+    static bool legal(uint32_t _opcode) {
+        return static_cast<uint32_t>(decodeOpcode(_opcode)) == _opcode;
+    }
+
+    static RegFile destinationOf(Instrn _cmd, uint32_t _funct3) {
+        switch(_cmd){
+            case Instrn::LOAD:
+            case Instrn::OP_IMM:
+            case Instrn::OP:
+            case Instrn::LUI:
+                return RegFile::INT;
+            case Instrn::LOAD_FP:
+            case Instrn::OP_FP:
+                return RegFile::FP;
+            case Instrn::OP_V:
+                return _funct3 <= 1 ? RegFile::VEC : (_funct3 == 3 ? RegFile::FP : RegFile::NONE);
+            default:
+                return RegFile::NONE;
+        }
+    }
+
+private:
+    uint32_t    imm;
+    Instrn      cmd;
+    RegFile     dst;
+    uint8_t     opcode;
+    uint8_t     rd;
+    uint8_t     rs1;
+    uint8_t     rs2;
+    uint8_t     funct3;
+    uint8_t     funct7;
+};
+
+/**
+* @brief 5-stage pipeline (Fetch, Decode, Execute, Memory, WriteBack) shared by control_core, control_tile and control_node
+* @details The controller derives from Pipeline<controller> and is the policy of the pipeline:
+*   - PIPELINE_MASK: output mask of pipeline traces
+*   - outFile: output for traces and errors
+*   - sendVector(dest, addr, size, funct3): COPY instruction (link set of the controller)
+*   - decodeCustom(instrn): CUSTOM instruction. The default rejects it as an unknown opcode.
+*   - awaitsResponse(addr, size): the StallReason of a CUSTOM response still due in [addr, addr+size), else STALL_NONE
+*     (the default).
+*   - awaitsCustom(instrn): the StallReason of a CUSTOM that needs the result of an earlier one in another unit, else
+*     STALL_NONE (the default).
+*   - memoryMap: mailboxes and buffers of the data memory, declared before loadProgram
+*   - pollRegion: regions of memoryMap the program spins on; the bubbles of re-reading one unchanged count as STALL_POLL
+*   - dmaEngine: optional DMA engine loaded after loadProgram. copyOut/copyIn go through it, or complete at once
+*     without one.
+* CUSTOM waits in Decode until earlier COPY reads have left, so it never overtakes their data.
+* The calls are resolved at compile time, so there is no virtual dispatch per instruction.
+* OP_V (opcode 87) is a vector extension over vectorLanes elements held in RegVEC, of the FPFormat in funct7
+* (0: E4M3, 1: FP16, 2: E5M2, 3: BF16):
+*   - funct3=0: vrd <- strided load at rs1+imm, stride rs2 bytes (0: packed)
+*   - funct3=1: vrd <- gather at rs1+imm indexed by the elements of vrs2
+*   - funct3=2: packed store of vrs2 at rs1+imm
+*   - funct3=3: frd += dot(vrs1, vrs2), a multiply-accumulate over all lanes in one FPU cycle
+* LOOP (opcode 91) repeats the next imm instructions RegINT[rs1] times; Fetch wraps the body without a branch.
+* Decode interlocks register hazards: results of Execute and Memory are forwarded, a load result is waited for one
+* cycle, loads of a region with a pending CUSTOM response wait for the response, and a CUSTOM waits for the results
+* of other units it uses (awaitsCustom). Programs need no NOP padding between dependent instructions, nor between a
+* COPY and the CUSTOM that uses its data.
+*/
+template<class Controller>
+class Pipeline {
+public:
+    void resetPipeline( uint32_t newPC );
+    void flushPipeline( uint32_t newPC );
+    void setupLoop( uint32_t count, uint32_t size );
+    bool performFetch();
+    bool performDecode();
+    bool performExecute();
+    bool performMemory();
+    bool performWriteBack();
+    void stepPipeline();
+    void stepFunctional();
+    void step();
+
+    float_t convertFP8toFP32(uint8_t fp8);
+    float_t simdMul(float_t a, float_t b);
+    float_t convertINTtoFP32(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth);
+
+protected:
+    static const uint32_t DEFAULT_LANES = 4;
+    static const uint32_t MAX_LANES = 64;
+
+    Pipeline() : loop_start(0), loop_end(0), loop_count(0), functional(false), functionalUntil(0), functionalWait(0), wakeLink(nullptr), stallReason(STALL_NONE), pollAddr(UINT32_MAX), pollValue(0), spinning(false), dataMemory(nullptr), dmaEngine(nullptr), RegINT(32, 0), RegFP(32, 0.0), stallCycle() { setLanes(DEFAULT_LANES); }
+    ~Pipeline() { delete dataMemory; }
+
+    void loadProgram(const Params &params, const std::vector<uint8_t> &dataMemoryTable);
+    void configureMode(const Params &params);
+    void configureWake();
+    bool suspendFunctional();
+    void handleWake(Event *ev);
+    void configureVector(const Params &params);
+    void setLanes(uint32_t lanes);
+    static uint32_t functionalCost(Instrn cmd, bool taken);
+    void decodeCustom(const InstructionEntry &instrn);
+    StallReason awaitsResponse(uint32_t addr, uint32_t size) { return STALL_NONE; }
+    StallReason awaitsCustom(const InstructionEntry &instrn) { return STALL_NONE; }
+    bool awaitsCopy() const;
+    template<class Done> void copyOut(uint32_t addr, uint32_t size, Done done);
+    template<class Done> void copyIn(uint32_t addr, Payload &&data, Done done);
+    Controller& controller() { return *static_cast<Controller*>(this); }
+
+    /** Execute handlers: one per (command, funct3, funct7), selected at load time *****/
+    typedef bool (Pipeline::*ExecuteHandler)();
+    ExecuteHandler selectExecute(const InstructionEntry &instrn);
+    bool executeNone();
+    bool executeCopy();
+    bool executeLoadGather();
+    bool executeLoad();
+    bool executeStore();
+    bool executeStoreFP();
+    bool executeAddi();
+    bool executeSlli();
+    bool executeAdd();
+    bool executeMul();
+    bool executeLui();
+    bool executeFadd();
+    bool executeFsub();
+    bool executeFmul8();
+    bool executeFdiv();
+    bool executeBeq();
+    bool executeBne();
+    bool executeKeepRd();
+    bool executeKeepFrd();
+    bool executeVectorLoad();
+    bool executeVectorGather();
+    bool executeVectorStore();
+    bool executeVectorMac();
+
+    /** Hazard detection ******************************************************/
+    bool readINT(uint32_t reg, uint32_t &value);
+    bool readFP(uint32_t reg, float_t &value);
+    bool readVEC(uint32_t reg, std::vector<uint16_t> &value);
+    bool awaitsLoad(uint32_t addr, uint32_t offset, uint32_t funct3);
+    bool awaits(uint32_t addr, uint32_t size);
+
+    /** Stall accounting ******************************************************/
+    void registerStallStatistics(uint32_t numReason);
+    void countStall(StallReason reason) { if (stallCycle[reason]) stallCycle[reason]->addData(1); }
+    void notePoll(uint32_t addr, uint32_t value);
+    bool rereadsPoll() const;
+
+    /** Vector extension ******************************************************/
+    bool decodeVector(const InstructionEntry &instrn);
+    uint32_t laneAddress(uint32_t funct3, uint32_t base, uint32_t stride, uint32_t width, const std::vector<uint16_t> &index, uint32_t lane) const;
+    static uint32_t laneWidth(uint32_t format) { return FPDecoder::width(format); }
+
+    /** Predecoded program, shared read-only by all controllers of this type with the same instruction table */
+    struct Program {
+        std::vector<InstructionEntry>   instructions;
+        std::vector<ExecuteHandler>     execute;
+    };
+    typedef std::unordered_map<std::string, std::shared_ptr<const Program>> ProgramRegistry;
+    static ProgramRegistry& programRegistry() {
+        static ProgramRegistry registry;
+        return registry;
+    }
+    static std::mutex& programRegistryMutex() {
+        static std::mutex lock;
+        return lock;
+    }
+
+    /** Pipeline Registers ****************************************************/
+    uint32_t                        pc;
+    bool                            fetch_halt;
+    uint32_t                        loop_start;
+    uint32_t                        loop_end;
+    uint32_t                        loop_count;
+    bool                            fetch_update;
+
+    bool                            decode_update;
+    Instrn                          decode_cmd;
+    ExecuteHandler                  decode_execute;
+    uint32_t                        decode_pc;
+    uint32_t                        decode_base;
+    uint32_t                        decode_rd;
+    uint32_t                        decode_rs1;
+    uint32_t                        decode_rs2;
+    float_t                         decode_frs1;
+    float_t                         decode_frs2;
+    uint32_t                        decode_imm;
+    uint32_t                        decode_funct3;
+    uint32_t                        decode_funct7;
+    RegFile                         decode_dst;
+    std::vector<uint16_t>           decode_vs1;
+    std::vector<uint16_t>           decode_vs2;
+
+    bool                            execute_update;
+    Instrn                          execute_cmd;
+    uint32_t                        execute_rd;
+    uint32_t                        execute_rs1;
+    uint32_t                        execute_rs2;
+    float_t                         execute_frs1;
+    float_t                         execute_frs2;
+    uint32_t                        execute_imm;
+    uint32_t                        execute_funct3;
+    uint32_t                        execute_funct7;
+    RegFile                         execute_dst;
+    std::vector<uint16_t>           execute_vec;
+
+    bool                            memory_update;
+    Instrn                          memory_cmd;
+    uint32_t                        memory_rd;
+    uint32_t                        memory_rs1;
+    float_t                         memory_frs1;
+    RegFile                         memory_dst;
+    std::vector<uint16_t>           memory_vec;
+
+    bool                            write_update;
+    Instrn                          write_cmd;
+    bool                            write_end;
+
+    /** Functional mode *******************************************************/
+    bool                            functional;
+    SimTime_t                       functionalUntil;
+    uint32_t                        functionalWait;
+    Link*                           wakeLink;
+
+    /** Stall accounting ******************************************************/
+    StallReason                     stallReason;
+    std::vector<uint32_t>           pollRegion;
+    uint32_t                        pollAddr;
+    uint32_t                        pollValue;
+    bool                            spinning;
+
+    /** Memory/Register file **************************************************/
+    std::shared_ptr<const Program>  program;
+    DataMemory*                     dataMemory;
+    MemoryMap                       memoryMap;
+    DMAEngine*                      dmaEngine;
+    std::vector<uint32_t>           RegINT;
+    std::vector<float_t>            RegFP;
+    std::vector<std::vector<uint16_t>> RegVEC;
+    uint32_t                        vectorLanes;
+
+    /** Statistics ************************************************************/
+    Statistic<uint32_t>*            activeCycleF;
+    Statistic<uint32_t>*            activeCycleD;
+    Statistic<uint32_t>*            activeCycleM;
+    Statistic<uint32_t>*            activeCycleALU;
+    Statistic<uint32_t>*            activeCycleFPU;
+    Statistic<uint32_t>*            stallCycle[NUM_STALL];
+};
+
+/**
+ * @brief Load the "instructionTable" parameter and the initial data memory.
+ * @details The data memory is sized to hold the table and every region of memoryMap, which the controller declares
+ * beforehand. Programs are keyed by the raw parameter text, so a table shared by many controllers on a rank is parsed
+ * and predecoded once. Data memory stays private to each controller.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::loadProgram(const Params &params, const std::vector<uint8_t> &dataMemoryTable){
+    std::string key = params.find<std::string>("instructionTable");
+    program.reset();
+    {
+        std::lock_guard<std::mutex> guard(programRegistryMutex());
+        typename ProgramRegistry::const_iterator it = programRegistry().find(key);
+        if (it != programRegistry().end()){
+            program = it->second;
+        }
+    }
+    if (!program){
+        std::vector<uint32_t> instructionTable;
+        params.find_array<uint32_t>("instructionTable", instructionTable);
+        if (instructionTable.size() % InstructionEntry::INSTRUCTION_FIELD != 0){
+            controller().outFile.fatal(CALL_INFO, -1, "Instruction table size %5zu is not a multiple of %" PRIu32 "\n", instructionTable.size(), InstructionEntry::INSTRUCTION_FIELD);
+        }
+        uint32_t numInstruction = instructionTable.size() / InstructionEntry::INSTRUCTION_FIELD;
+        std::shared_ptr<Program> decoded = std::make_shared<Program>();
+        decoded->instructions.reserve(numInstruction);
+        decoded->execute.reserve(numInstruction);
+        for (uint32_t i = 0, j = 0; i < numInstruction; ++i, j+=InstructionEntry::INSTRUCTION_FIELD){
+            if (!InstructionEntry::fits(instructionTable[j], instructionTable[j+1], instructionTable[j+2], instructionTable[j+3], instructionTable[j+5], instructionTable[j+6])){
+                controller().outFile.fatal(CALL_INFO, -1, "Instruction %5" PRIu32 " has a field out of range\n", i);
+            }
+            if (!InstructionEntry::legal(instructionTable[j])){
+                controller().outFile.fatal(CALL_INFO, -1, "Instruction %5" PRIu32 " has an illegal opcode:%5" PRIu32 "\n", i, instructionTable[j]);
+            }
+            decoded->instructions.push_back(InstructionEntry(instructionTable[j], instructionTable[j+1], instructionTable[j+2], instructionTable[j+3], instructionTable[j+4], instructionTable[j+5], instructionTable[j+6]));
+            if (decoded->instructions.back().getCmd() == Instrn::OP_V && !FPDecoder::valid(instructionTable[j+6])){
+                controller().outFile.fatal(CALL_INFO, -1, "Instruction %5" PRIu32 " has an unknown format:%5" PRIu32 "\n", i, instructionTable[j+6]);
+            }
+            decoded->execute.push_back(selectExecute(decoded->instructions.back()));
+        }
+        std::lock_guard<std::mutex> guard(programRegistryMutex());
+        // Another controller may have registered the same program meanwhile: keep the first one
+        program = programRegistry().emplace(key, decoded).first->second;
+    }
+    delete dataMemory;
+    dataMemory = new DataMemory(dataMemoryTable, memoryMap.configure(params, dataMemoryTable.size(), controller().outFile));
+}
+
+/**
+ * @brief Read the simulation mode of the controller.
+ * @details mode=functional executes one whole instruction per step and charges functionalCost cycles for it; the clock
+ * stops for all but the first (suspendFunctional).
+ * If functionalUntil is set, the controller switches to the cycle-accurate pipeline at that simulated time.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::configureMode(const Params &params){
+    std::string mode = params.find<std::string>("mode", "cycle");
+    if (mode == "functional"){
+        functional = true;
+    }
+    else if (mode != "cycle"){
+        controller().outFile.fatal(CALL_INFO, -1, "Unknown mode: %s\n", mode.c_str());
+    }
+    std::string until = params.find<std::string>("functionalUntil", "");
+    if (!until.empty() && !functional){
+        // Only the functional-to-cycle switch is modeled: the pipeline state cannot be folded back into one instruction
+        controller().outFile.fatal(CALL_INFO, -1, "functionalUntil switches from functional to cycle mode and needs mode=functional\n");
+    }
+    functionalUntil = until.empty() ? 0 : controller().getTimeConverter(until)->getFactor();
+}
+
+/**
+ * @brief Read the lane count of the vector extension ("vectorLanes").
+ */
+template<class Controller>
+void
+Pipeline<Controller>::configureVector(const Params &params){
+    uint32_t lanes = params.find<uint32_t>("vectorLanes", DEFAULT_LANES);
+    if (lanes == 0 || lanes > MAX_LANES){
+        controller().outFile.fatal(CALL_INFO, -1, "vectorLanes %5" PRIu32 " is out of range [1, %" PRIu32 "]\n", lanes, MAX_LANES);
+    }
+    setLanes(lanes);
+}
+
+template<class Controller>
+void
+Pipeline<Controller>::setLanes(uint32_t lanes){
+    vectorLanes = lanes;
+    RegVEC.assign(32, std::vector<uint16_t>(lanes, 0));
+    decode_vs1.assign(lanes, 0);
+    decode_vs2.assign(lanes, 0);
+    execute_vec.assign(lanes, 0);
+    memory_vec.assign(lanes, 0);
+}
+
+/**
+ * @brief True while a COPY read ahead of the decoded instruction has not left: in Execute, or still in the DMA engine.
+ */
+template<class Controller>
+bool
+Pipeline<Controller>::awaitsCopy() const {
+    if (!functional && execute_update && execute_cmd == Instrn::COPY){
+        return true;
+    }
+    return dmaEngine && dmaEngine->readPending();
+}
+
+/**
+ * @brief Read [addr, addr+size) into a payload and pass it to 'done', through the DMA engine if there is one.
+ */
+template<class Controller>
+template<class Done>
+void
+Pipeline<Controller>::copyOut(uint32_t addr, uint32_t size, Done done){
+    if (dmaEngine){
+        dmaEngine->read(addr, size, done);
+        return;
+    }
+    done(Payload(dataMemory->at(addr), dataMemory->at(addr + size)));
+}
+
+/**
+ * @brief Write a received payload at 'addr' and call 'done', through the DMA engine if there is one.
+ */
+template<class Controller>
+template<class Done>
+void
+Pipeline<Controller>::copyIn(uint32_t addr, Payload &&data, Done done){
+    if (dmaEngine){
+        dmaEngine->write(addr, std::move(data), done);
+        return;
+    }
+    dataMemory->write(addr, data.begin(), data.size());
+    done();
+}
+
+/**
+ * @brief Cycles charged per instruction in functional mode.
+ * @details One issue cycle. A taken branch adds the one flushed fetch. CUSTOM adds the two cycles between Decode,
+ * where the request is sent, and Memory, as in the pipeline. Loads of a pending response wait for it in either mode.
+ */
+template<class Controller>
+uint32_t
+Pipeline<Controller>::functionalCost(Instrn cmd, bool taken){
+    if (taken){
+        return 2;
+    }
+    if (cmd == Instrn::CUSTOM){
+        return 3;
+    }
+    return 1;
+}
+
+template<class Controller>
+void
+Pipeline<Controller>::resetPipeline(uint32_t newPC){
+    pc = newPC;
+    fetch_halt = false;
+    fetch_update = false;
+
+    decode_update = false;
+    decode_cmd = Instrn::OP_IMM;
+    decode_execute = &Pipeline::executeNone;
+    decode_pc = 0;
+    decode_base = 0;
+    decode_rd = 0;
+    decode_rs1 = 0;
+    decode_rs2 = 0;
+    decode_frs1 = 0.0;
+    decode_frs2 = 0.0;
+    decode_imm = 0;
+    decode_funct3 = 0;
+    decode_funct7 = 0;
+    decode_dst = RegFile::NONE;
+
+    execute_update = false;
+    execute_cmd = Instrn::OP_IMM;
+    execute_rd = 0;
+    execute_rs1 = 0;
+    execute_rs2 = 0;
+    execute_frs1 = 0.0;
+    execute_frs2 = 0.0;
+    execute_imm = 0;
+    execute_funct3 = 0;
+    execute_funct7 = 0;
+    execute_dst = RegFile::NONE;
+
+    memory_update = false;
+    memory_cmd = Instrn::OP_IMM;
+    memory_rd = 0;
+    memory_rs1 = 0;
+    memory_frs1 = 0.0;
+    memory_dst = RegFile::NONE;
+
+    write_update = false;
+    write_cmd = Instrn::OP_IMM;
+    write_end = false;
+}
+
+/**
+ * @brief Arm the hardware loop from Decode of LOOP (opcode 91): the next 'size' instructions run 'count' times.
+ * @details Nothing past LOOP has been fetched yet, so Fetch starts the body, or skips it if count is 0, in the
+ * same cycle. One loop level is supported; a new LOOP replaces the current one.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::setupLoop(uint32_t count, uint32_t size){
+    loop_start = decode_pc + 1;
+    loop_end = decode_pc + size;
+    if (count == 0 || size == 0){
+        loop_count = 0;
+        pc = loop_end + 1;
+    }
+    else{
+        loop_count = count - 1;
+    }
+}
+
+/**
+ * @brief Redirect fetch after a taken branch.
+ * @details Only the younger instructions in Fetch and Decode are dropped; older ones in Memory and WriteBack complete.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::flushPipeline(uint32_t newPC){
+    pc = newPC;
+    fetch_halt = false;
+    fetch_update = false;
+    decode_update = false;
+    // A taken branch leaves the hardware loop
+    loop_count = 0;
+    // Functional mode charges branches through functionalCost, not as pipeline bubbles
+    if (!functional){
+        countStall(spinning ? STALL_POLL : STALL_FLUSH);
+    }
+    spinning = false;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::performFetch(){
+    // Nothing past RET is fetched, so programs need no padding after it
+    if (fetch_halt){
+        return false;
+    }
+    activeCycleF->addData(1);
+    // Zero-overhead loop: wrap from the end of the body to its start without a branch
+    if (loop_count > 0 && pc == loop_end + 1){
+        pc = loop_start;
+        loop_count--;
+    }
+    if (pc >= program->instructions.size()){
+        controller().outFile.fatal(CALL_INFO, -1, "PC is out of range: PC %5" PRIu32 " >= Instruction memory size %5zu\n", pc, program->instructions.size());
+        return false;
+    }
+    else{
+        decode_pc = pc;
+        fetch_halt = program->instructions[pc].getCmd() == Instrn::RET;
+        pc++;
+        CAMSHAP_VERBOSE(controller().outFile, 2, Controller::PIPELINE_MASK, "%10s - PC:%3" PRIu32 "\n", "Fetch", decode_pc);
+        return true;
+    }
+}
+
+/**
+ * @brief Default CUSTOM handling: controllers without accelerators reject it.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::decodeCustom(const InstructionEntry &instrn){
+    controller().outFile.fatal(CALL_INFO, -1, "Decode: Unknown opcode:%5" PRIu32 "\n", instrn.getOpcode());
+}
+
+/**
+ * @brief Read an integer register in Decode.
+ * @details The results produced this cycle by Execute (younger) and Memory are forwarded ahead of the register file.
+ * A load still in Execute has no data yet: the read fails and Decode stalls.
+ */
+template<class Controller>
+bool
+Pipeline<Controller>::readINT(uint32_t reg, uint32_t &value){
+    if (execute_update && execute_dst == RegFile::INT && execute_rd == reg){
+        if (execute_cmd == Instrn::LOAD){
+            return false;
+        }
+        value = execute_rs1;
+        return true;
+    }
+    if (memory_update && memory_dst == RegFile::INT && memory_rd == reg){
+        value = memory_rs1;
+        return true;
+    }
+    value = RegINT[reg];
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::readFP(uint32_t reg, float_t &value){
+    if (execute_update && execute_dst == RegFile::FP && execute_rd == reg){
+        if (execute_cmd == Instrn::LOAD_FP){
+            return false;
+        }
+        value = execute_frs1;
+        return true;
+    }
+    if (memory_update && memory_dst == RegFile::FP && memory_rd == reg){
+        value = memory_frs1;
+        return true;
+    }
+    value = RegFP[reg];
+    return true;
+}
+
+/** Vector registers are only written by loads, so a producer still in Execute always stalls */
+template<class Controller>
+bool
+Pipeline<Controller>::readVEC(uint32_t reg, std::vector<uint16_t> &value){
+    if (execute_update && execute_dst == RegFile::VEC && execute_rd == reg){
+        return false;
+    }
+    if (memory_update && memory_dst == RegFile::VEC && memory_rd == reg){
+        value = memory_vec;
+        return true;
+    }
+    value = RegVEC[reg];
+    return true;
+}
+
+/**
+ * @brief Read the operands of an OP_V instruction. Vector loads also wait for pending CUSTOM responses in any lane.
+ */
+template<class Controller>
+bool
+Pipeline<Controller>::decodeVector(const InstructionEntry &instrn){
+    decode_rd       = instrn.getRd();
+    decode_imm      = instrn.getImm();
+    decode_funct3   = instrn.getFunct3();
+    decode_funct7   = instrn.getFunct7();
+    switch (decode_funct3){
+        case 0:
+        case 1:{
+            bool ready = readINT(instrn.getRs1(), decode_rs1);
+            ready = ready && (decode_funct3 == 0 ? readINT(instrn.getRs2(), decode_rs2) : readVEC(instrn.getRs2(), decode_vs2));
+            if (!ready){
+                return false;
+            }
+            uint32_t width = laneWidth(decode_funct7);
+            for (uint32_t i = 0; i < vectorLanes; i++){
+                if (awaits(laneAddress(decode_funct3, decode_rs1 + decode_imm, decode_rs2, width, decode_vs2, i), width)){
+                    return false;
+                }
+            }
+            return true;
+        }
+        case 2:
+            return readINT(instrn.getRs1(), decode_rs1) && readVEC(instrn.getRs2(), decode_vs2);
+        case 3:
+            return readFP(instrn.getRd(), decode_frs1) && readVEC(instrn.getRs1(), decode_vs1) && readVEC(instrn.getRs2(), decode_vs2);
+        default:
+            return true;
+    }
+}
+
+/**
+ * @brief Address of one lane of a vector access.
+ * @details funct3=1 gathers at base + index*width; the others are strided, a stride of 0 meaning packed lanes.
+ */
+template<class Controller>
+uint32_t
+Pipeline<Controller>::laneAddress(uint32_t funct3, uint32_t base, uint32_t stride, uint32_t width, const std::vector<uint16_t> &index, uint32_t lane) const{
+    if (funct3 == 1){
+        return base + index[lane] * width;
+    }
+    return base + lane * (stride ? stride : width);
+}
+
+/**
+ * @brief True if a load would read bytes of a CUSTOM response that has not arrived yet.
+ * @details funct3=0 gathers one byte from each of the 4 addresses packed in addr, otherwise a word is read at addr+offset.
+ */
+template<class Controller>
+bool
+Pipeline<Controller>::awaitsLoad(uint32_t addr, uint32_t offset, uint32_t funct3){
+    if (funct3 != 0){
+        return awaits(addr + offset, 4);
+    }
+    for (uint32_t i = 0; i < 32; i+=8){
+        if (awaits(((addr >> i) & 0xff) + offset, 1)){
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief True if [addr, addr+size) holds a CUSTOM response that has not arrived yet. The controller names the unit it waits for.
+ */
+template<class Controller>
+bool
+Pipeline<Controller>::awaits(uint32_t addr, uint32_t size){
+    StallReason reason = controller().awaitsResponse(addr, size);
+    if (reason == STALL_NONE){
+        return false;
+    }
+    stallReason = reason;
+    return true;
+}
+
+/**
+ * @brief Register stallCycle with one subId per reason below numReason.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::registerStallStatistics(uint32_t numReason){
+    for (uint32_t i = STALL_HAZARD; i < numReason; i++){
+        stallCycle[i] = controller().template registerStatistic<uint32_t>("stallCycle", stallName(i));
+    }
+}
+
+/**
+ * @brief Remember a read of a polled mailbox. If it shows the same word unchanged, the program is spinning and the
+ * flush of the branch back to the read counts as STALL_POLL.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::notePoll(uint32_t addr, uint32_t value){
+    for (uint32_t i = 0; i < pollRegion.size(); i++){
+        const MemoryRegion &region = memoryMap[pollRegion[i]];
+        if (addr < region.base || addr >= region.end()){
+            continue;
+        }
+        spinning = addr == pollAddr && value == pollValue;
+        pollAddr = addr;
+        pollValue = value;
+        return;
+    }
+}
+
+/**
+ * @brief True if the load in Execute re-reads the last polled mailbox word and finds it unchanged, so that waiting for
+ * its result is part of a spin.
+ */
+template<class Controller>
+bool
+Pipeline<Controller>::rereadsPoll() const {
+    return execute_update && execute_cmd == Instrn::LOAD && execute_funct3 != 0 && execute_rs1 == pollAddr && dataMemory->getINT_4B(pollAddr) == pollValue;
+}
+
+/**
+ * @brief Read the operands of the fetched instruction.
+ * @details Returns false on a hazard: the instruction stays in Fetch and a bubble goes to Execute. Only CUSTOM has a
+ * side effect, which happens once it no longer stalls. The stall is counted under the reason that caused it: a register
+ * hazard unless a pending response or COPY read says otherwise, or a poll if the load waited for re-reads an unchanged
+ * mailbox.
+ */
+template<class Controller>
+bool
+Pipeline<Controller>::performDecode(){
+    bool ready = true;
+    stallReason = STALL_HAZARD;
+    const InstructionEntry &instrn = program->instructions[decode_pc];
+    decode_cmd = instrn.getCmd();
+    decode_execute = program->execute[decode_pc];
+    decode_dst = instrn.getDst();
+    decode_base = decode_pc + 2;
+    switch (decode_cmd){
+        case Instrn::COPY:
+            ready           = readINT(instrn.getRd(), decode_rd) && readINT(instrn.getRs1(), decode_rs1) && readINT(instrn.getRs2(), decode_rs2);
+            ready           = ready && !awaits(decode_rs1, decode_rs2);
+            decode_funct3   = instrn.getFunct3();
+            break;
+        case Instrn::LOAD:
+        case Instrn::LOAD_FP:
+            decode_rd       = instrn.getRd();
+            decode_imm      = instrn.getImm();
+            decode_funct3   = instrn.getFunct3();
+            ready           = readINT(instrn.getRs1(), decode_rs1) && !awaitsLoad(decode_rs1, decode_imm, decode_funct3);
+            break;
+        case Instrn::OP_IMM:
+            decode_rd       = instrn.getRd();
+            ready           = readINT(instrn.getRs1(), decode_rs1);
+            decode_imm      = instrn.getImm();
+            decode_funct3   = instrn.getFunct3();
+            break;
+        case Instrn::STORE:
+            ready           = readINT(instrn.getRs1(), decode_rs1) && readINT(instrn.getRs2(), decode_rs2);
+            decode_imm      = instrn.getImm();
+            decode_funct3   = instrn.getFunct3();
+            break;
+        case Instrn::STORE_FP:
+            ready           = readINT(instrn.getRs1(), decode_rs1) && readFP(instrn.getRs2(), decode_frs2);
+            decode_imm      = instrn.getImm();
+            decode_funct3   = instrn.getFunct3();
+            break;
+        case Instrn::OP:
+            decode_rd       = instrn.getRd();
+            ready           = readINT(instrn.getRs1(), decode_rs1) && readINT(instrn.getRs2(), decode_rs2);
+            decode_funct3   = instrn.getFunct3();
+            decode_funct7   = instrn.getFunct7();
+            break;
+        case Instrn::OP_FP:
+            decode_rd       = instrn.getRd();
+            ready           = readFP(instrn.getRs1(), decode_frs1) && readFP(instrn.getRs2(), decode_frs2);
+            decode_funct3   = instrn.getFunct3();
+            decode_funct7   = instrn.getFunct7();
+            break;
+        case Instrn::LUI:
+            decode_rd       = instrn.getRd();
+            decode_imm      = instrn.getImm();
+            break;
+        case Instrn::BRANCH:
+            ready           = readINT(instrn.getRs1(), decode_rs1) && readINT(instrn.getRs2(), decode_rs2);
+            decode_imm      = instrn.getImm();
+            decode_funct3   = instrn.getFunct3();
+            break;
+        case Instrn::RET:
+            break;
+        case Instrn::OP_V:
+            ready           = decodeVector(instrn);
+            break;
+        case Instrn::LOOP:
+            ready           = readINT(instrn.getRs1(), decode_rs1);
+            decode_imm      = instrn.getImm();
+            if (ready){
+                setupLoop(decode_rs1, decode_imm);
+            }
+            break;
+        case Instrn::CUSTOM:
+            decode_funct3   = instrn.getFunct3();
+            decode_imm      = instrn.getImm();
+            stallReason     = awaitsCopy() ? STALL_COPY : controller().awaitsCustom(instrn);
+            ready           = stallReason == STALL_NONE;
+            if (ready){
+                controller().decodeCustom(instrn);
+            }
+            break;
+        default:
+            controller().outFile.fatal(CALL_INFO, -1, "Decode: Unknown opcode:%5" PRIu32 "\n", static_cast<uint32_t>(decode_cmd));
+            break;
+    }
+    if (!ready){
+        CAMSHAP_VERBOSE(controller().outFile, 2, Controller::PIPELINE_MASK, "%10s - PC:%3" PRIu32 "\n", "Stall", decode_pc);
+        if (stallReason == STALL_HAZARD && rereadsPoll()){
+            stallReason = STALL_POLL;
+        }
+        countStall(stallReason);
+        return false;
+    }
+    activeCycleD->addData(1);
+    CAMSHAP_VERBOSE(controller().outFile, 2, Controller::PIPELINE_MASK, "%10s - Opcode:%3" PRIu32 ", Rd:%8" PRIu32 ", Rs1:%8" PRIu32 ", Rs2:%8" PRIu32 ", Imm:%8" PRIu32 ", FRs1:%8.3f, FRs2:%8.3f, Funct3:%8" PRIu32", Funct7:%8" PRIu32"\n", "Decode", static_cast<uint32_t>(decode_cmd), decode_rd, decode_rs1, decode_rs2, decode_imm, decode_frs1, decode_frs2, decode_funct3, decode_funct7);
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::performExecute(){
+    execute_cmd = decode_cmd;
+    execute_dst = decode_dst;
+    bool update = (this->*decode_execute)();
+    CAMSHAP_VERBOSE(controller().outFile, 2, Controller::PIPELINE_MASK, "%10s - Opcode:%3" PRIu32 ", Rd:%8" PRIu32 ", Rs1:%8" PRIu32 ", Rs2:%8" PRIu32 ", Imm:%8" PRIu32 ", FRs1:%8.3f, FRs2:%8.3f, Funct3:%8" PRIu32", Funct7:%8" PRIu32"\n", "Execute", static_cast<uint32_t>(execute_cmd), execute_rd, execute_rs1, execute_rs2, execute_imm, execute_frs1, execute_frs2, execute_funct3, execute_funct7);
+    return update;
+}
+
+/**
+ * @brief Pick the execute handler of an instruction, so that Execute does a single indirect call instead of nested switches.
+ * @details Function codes without an operation only latch the destination, as before.
+ */
+template<class Controller>
+typename Pipeline<Controller>::ExecuteHandler
+Pipeline<Controller>::selectExecute(const InstructionEntry &instrn){
+    switch (instrn.getCmd()){
+        case Instrn::COPY:
+            return &Pipeline::executeCopy;
+        case Instrn::LOAD:
+        case Instrn::LOAD_FP:
+            return instrn.getFunct3() == 0 ? &Pipeline::executeLoadGather : &Pipeline::executeLoad;
+        case Instrn::STORE:
+            return &Pipeline::executeStore;
+        case Instrn::STORE_FP:
+            return &Pipeline::executeStoreFP;
+        case Instrn::OP_IMM:
+            switch (instrn.getFunct3()){
+                case 0:
+                    return &Pipeline::executeAddi;
+                case 1:
+                    return &Pipeline::executeSlli;
+                default:
+                    return &Pipeline::executeKeepRd;
+            }
+        case Instrn::OP:
+            if (instrn.getFunct3() == 0 && instrn.getFunct7() == 0){
+                return &Pipeline::executeAdd;
+            }
+            if (instrn.getFunct3() == 0 && instrn.getFunct7() == 1){
+                return &Pipeline::executeMul;
+            }
+            return &Pipeline::executeKeepRd;
+        case Instrn::LUI:
+            return &Pipeline::executeLui;
+        case Instrn::OP_FP:
+            switch (instrn.getFunct7()){
+                case 0:
+                    return &Pipeline::executeFadd;
+                case 4:
+                    return &Pipeline::executeFsub;
+                case 8:
+                    return &Pipeline::executeFmul8;
+                case 12:
+                    return &Pipeline::executeFdiv;
+                default:
+                    return &Pipeline::executeKeepFrd;
+            }
+        case Instrn::BRANCH:
+            switch (instrn.getFunct3()){
+                case 0:
+                    return &Pipeline::executeBeq;
+                case 1:
+                    return &Pipeline::executeBne;
+                default:
+                    return &Pipeline::executeKeepRd;
+            }
+        case Instrn::OP_V:
+            switch (instrn.getFunct3()){
+                case 0:
+                    return &Pipeline::executeVectorLoad;
+                case 1:
+                    return &Pipeline::executeVectorGather;
+                case 2:
+                    return &Pipeline::executeVectorStore;
+                case 3:
+                    return &Pipeline::executeVectorMac;
+                default:
+                    return &Pipeline::executeNone;
+            }
+        case Instrn::CUSTOM:
+        case Instrn::LOOP:
+        case Instrn::RET:
+        default:
+            return &Pipeline::executeNone;
+    }
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeNone(){
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeCopy(){
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_rs1;
+    execute_rs2     = decode_rs2;
+    execute_funct3  = decode_funct3;
+    return true;
+}
+
+/** Gather 4 bytes from the addresses packed in rs1 */
+template<class Controller>
+bool
+Pipeline<Controller>::executeLoadGather(){
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_rs1;
+    execute_imm     = decode_imm;
+    execute_funct3  = decode_funct3;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeLoad(){
+    activeCycleALU->addData(1);
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_rs1 + decode_imm;
+    execute_funct3  = decode_funct3;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeStore(){
+    activeCycleALU->addData(1);
+    execute_rs1     = decode_rs1 + decode_imm;
+    execute_rs2     = decode_rs2;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeStoreFP(){
+    activeCycleALU->addData(1);
+    execute_rs1     = decode_rs1 + decode_imm;
+    execute_frs2    = decode_frs2;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeAddi(){
+    activeCycleALU->addData(1);
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_rs1 + decode_imm;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeSlli(){
+    activeCycleALU->addData(1);
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_rs1 << (decode_imm & 0x1f);
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeAdd(){
+    activeCycleALU->addData(1);
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_rs1 + decode_rs2;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeMul(){
+    activeCycleALU->addData(1);
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_rs1 * decode_rs2;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeLui(){
+    activeCycleALU->addData(1);
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_imm << 12;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeFadd(){
+    activeCycleFPU->addData(1);
+    execute_rd      = decode_rd;
+    execute_frs1    = decode_frs1 + decode_frs2;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeFsub(){
+    activeCycleFPU->addData(1);
+    execute_rd      = decode_rd;
+    execute_frs1    = decode_frs1 - decode_frs2;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeFmul8(){
+    activeCycleFPU->addData(1);
+    execute_rd      = decode_rd;
+    execute_frs1    = simdMul(decode_frs1, decode_frs2);
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeFdiv(){
+    activeCycleFPU->addData(1);
+    execute_rd      = decode_rd;
+    execute_frs1    = decode_frs1 / decode_frs2;
+    return true;
+}
+
+/** Branch offset: bit 11 of imm is the sign, bits 7:0 the magnitude. It is relative to two past the branch, the fetch PC when the branch resolves. */
+template<class Controller>
+bool
+Pipeline<Controller>::executeBeq(){
+    activeCycleALU->addData(1);
+    if (decode_rs1 == decode_rs2){
+        int32_t offset = (decode_imm >> 11) & 1 ? -int32_t(decode_imm & 0xff) : int32_t(decode_imm & 0xff);
+        flushPipeline(decode_base + offset);
+        return false;
+    }
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeBne(){
+    activeCycleALU->addData(1);
+    if (decode_rs1 != decode_rs2){
+        int32_t offset = (decode_imm >> 11) & 1 ? -int32_t(decode_imm & 0xff) : int32_t(decode_imm & 0xff);
+        flushPipeline(decode_base + offset);
+        return false;
+    }
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeKeepRd(){
+    activeCycleALU->addData(1);
+    execute_rd      = decode_rd;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeKeepFrd(){
+    activeCycleFPU->addData(1);
+    execute_rd      = decode_rd;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeVectorLoad(){
+    activeCycleALU->addData(1);
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_rs1 + decode_imm;
+    execute_rs2     = decode_rs2;
+    execute_funct3  = decode_funct3;
+    execute_funct7  = decode_funct7;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeVectorGather(){
+    activeCycleALU->addData(1);
+    execute_rd      = decode_rd;
+    execute_rs1     = decode_rs1 + decode_imm;
+    execute_vec     = decode_vs2;
+    execute_funct3  = decode_funct3;
+    execute_funct7  = decode_funct7;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::executeVectorStore(){
+    activeCycleALU->addData(1);
+    execute_rs1     = decode_rs1 + decode_imm;
+    execute_vec     = decode_vs2;
+    execute_funct3  = decode_funct3;
+    execute_funct7  = decode_funct7;
+    return true;
+}
+
+/** Packed multiply-accumulate: all lanes are multiplied and summed into frd in one FPU cycle */
+template<class Controller>
+bool
+Pipeline<Controller>::executeVectorMac(){
+    activeCycleFPU->addData(1);
+    execute_rd      = decode_rd;
+    execute_funct3  = decode_funct3;
+    float_t sum = decode_frs1;
+    for (uint32_t i = 0; i < vectorLanes; i++){
+        sum += FPDecoder::decode(decode_vs1[i], decode_funct7) * FPDecoder::decode(decode_vs2[i], decode_funct7);
+    }
+    execute_frs1    = sum;
+    return true;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::performMemory(){
+    bool update = true;
+    memory_cmd      = execute_cmd;
+    memory_dst      = execute_dst;
+    memory_rd       = execute_rd;
+    memory_rs1      = execute_rs1;
+    memory_frs1     = execute_frs1;
+    switch (memory_cmd){
+        case Instrn::COPY:
+            activeCycleM->addData(1);
+            controller().sendVector(execute_rd, execute_rs1, execute_rs2, execute_funct3);
+            break;
+        case Instrn::LOAD:{
+            activeCycleM->addData(1);
+            switch (execute_funct3){
+                case 0:
+                    memory_rs1 = dataMemory->getINT_1B_4(execute_rs1, execute_imm);
+                    break;
+                default:
+                    memory_rs1 = dataMemory->getINT_4B(execute_rs1);
+                    notePoll(execute_rs1, memory_rs1);
+                    break;
+            }
+            break;
+        }
+        case Instrn::LOAD_FP:{
+            activeCycleM->addData(1);
+            switch (execute_funct3){
+                case 0:
+                    memory_frs1 = dataMemory->getFP_1B_4(execute_rs1, execute_imm);
+                    break;
+                default:
+                    memory_frs1 = dataMemory->getFP_4B(execute_rs1);
+                    break;
+            }
+            break;
+        }
+        case Instrn::STORE:
+            activeCycleM->addData(1);
+            dataMemory->putINT_4B(execute_rs1, execute_rs2);
+            break;
+        case Instrn::STORE_FP:
+            activeCycleM->addData(1);
+            dataMemory->putFP_4B(execute_rs1, execute_frs2);
+            break;
+        case Instrn::OP_V:{
+            uint32_t width = laneWidth(execute_funct7);
+            switch (execute_funct3){
+                case 0:
+                case 1:
+                    activeCycleM->addData(1);
+                    for (uint32_t i = 0; i < vectorLanes; i++){
+                        uint32_t addr = laneAddress(execute_funct3, execute_rs1, execute_rs2, width, execute_vec, i);
+                        memory_vec[i] = width == 2 ? dataMemory->getINT_2B(addr) : dataMemory->getINT_1B(addr);
+                    }
+                    break;
+                case 2:
+                    activeCycleM->addData(1);
+                    for (uint32_t i = 0; i < vectorLanes; i++){
+                        uint32_t addr = execute_rs1 + i * width;
+                        dataMemory->putINT_1B(addr, execute_vec[i] & 0xff);
+                        if (width == 2){
+                            dataMemory->putINT_1B(addr+1, execute_vec[i] >> 8);
+                        }
+                    }
+                    break;
+            }
+            break;
+        }
+        case Instrn::OP_IMM:
+        case Instrn::OP:
+        case Instrn::LUI:
+        case Instrn::OP_FP:
+        case Instrn::BRANCH:
+        case Instrn::CUSTOM:
+        case Instrn::LOOP:
+        case Instrn::RET:
+            break;
+        default:
+            controller().outFile.fatal(CALL_INFO, -1, "Memory: Unknown opcode:%5" PRIu32 "\n", static_cast<uint32_t>(memory_cmd));
+            break;
+    }
+    CAMSHAP_VERBOSE(controller().outFile, 2, Controller::PIPELINE_MASK, "%10s - Opcode:%3" PRIu32 ", Rd:%8" PRIu32 ", Rs1:%8" PRIu32 ", FRs1:%8.3f\n", "Memory", static_cast<uint32_t>(memory_cmd), memory_rd, memory_rs1, memory_frs1);
+    return update;
+}
+
+template<class Controller>
+bool
+Pipeline<Controller>::performWriteBack(){
+    bool update = true;
+    write_cmd       = memory_cmd;
+    switch (write_cmd){
+        case Instrn::LOAD:
+        case Instrn::OP_IMM:
+        case Instrn::OP:
+        case Instrn::LUI:
+            RegINT[memory_rd] = memory_rs1;
+            break;
+        case Instrn::OP_FP:
+        case Instrn::LOAD_FP:
+            RegFP[memory_rd] = memory_frs1;
+            break;
+        case Instrn::OP_V:
+            if (memory_dst == RegFile::VEC){
+                RegVEC[memory_rd] = memory_vec;
+            }
+            else if (memory_dst == RegFile::FP){
+                RegFP[memory_rd] = memory_frs1;
+            }
+            break;
+        case Instrn::STORE:
+        case Instrn::STORE_FP:
+        case Instrn::BRANCH:
+        case Instrn::COPY:
+        case Instrn::CUSTOM:
+        case Instrn::LOOP:
+            break;
+        case Instrn::RET:
+            write_end = true;
+            break;
+        default:
+            controller().outFile.fatal(CALL_INFO, -1, "WriteBack: Unknown opcode:%5" PRIu32 "\n", static_cast<uint32_t>(write_cmd));
+            break;
+    }
+    CAMSHAP_VERBOSE(controller().outFile, 2, Controller::PIPELINE_MASK, "%10s - Opcode:%3" PRIu32 ", Rd:%8" PRIu32 ", Rs1:%8" PRIu32 ", FRs1:%8.3f\n", "WriteBack", static_cast<uint32_t>(write_cmd), memory_rd, memory_rs1, memory_frs1);
+    return update;
+}
+
+/**
+ * @brief Advance the pipeline by one cycle.
+ * @details Stages are evaluated from WriteBack to Fetch so that each stage reads the registers of the previous cycle.
+ * A stage without input passes a bubble on. When Decode stalls, Fetch holds its instruction.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::stepPipeline(){
+    write_update = memory_update && performWriteBack();
+    memory_update = execute_update && performMemory();
+    // A taken branch flushes Fetch and Decode here
+    execute_update = decode_update && performExecute();
+    decode_update = fetch_update && performDecode();
+    if (fetch_update && !decode_update){
+        return;
+    }
+    fetch_update = performFetch();
+}
+
+/**
+ * @brief Run one instruction through all stages at once. The rest of its analytic cost is left in functionalWait for
+ * suspendFunctional.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::stepFunctional(){
+    if (write_end){
+        return;
+    }
+    // Fetch may wrap a LOOP body, so a stall restores the iteration count along with the PC
+    uint32_t fetchPC = pc;
+    uint32_t fetchLoop = loop_count;
+    performFetch();
+    if (!performDecode()){
+        // Waiting for a CUSTOM response or a COPY read: fetch the same instruction again next cycle
+        pc = fetchPC;
+        loop_count = fetchLoop;
+        return;
+    }
+    Instrn cmd = decode_cmd;
+    bool taken = !performExecute();
+    if (!taken){
+        performMemory();
+        performWriteBack();
+    }
+    functionalWait = functionalCost(cmd, taken) - 1;
+}
+
+/**
+ * @brief Configure the self link that restarts the clock of a functional controller (after registerClock).
+ */
+template<class Controller>
+void
+Pipeline<Controller>::configureWake(){
+    if (functional){
+        wakeLink = controller().configureSelfLink("wake", controller().clockPeriod, new Event::Handler<Pipeline>(this, &Pipeline::handleWake));
+    }
+}
+
+/**
+ * @brief True if the clock of a functional controller can stop for the rest of the last instruction's cost.
+ * @details The clock handler returns it. handleWake restarts the clock after functionalWait cycles, so the next
+ * instruction issues on the same edge as if the controller had ticked through the wait.
+ */
+template<class Controller>
+bool
+Pipeline<Controller>::suspendFunctional(){
+    if (!functional || functionalWait == 0 || !wakeLink){
+        return false;
+    }
+    wakeLink->send(functionalWait, new CAMSHAPCoreEvent(0, 0, 0, Payload()));
+    return true;
+}
+
+template<class Controller>
+void
+Pipeline<Controller>::handleWake(Event *ev){
+    delete ev;
+    functionalWait = 0;
+    controller().reregisterClock(controller().clockPeriod, controller().clockHandler);
+}
+
+/**
+ * @brief Advance the controller by one cycle in its current mode.
+ * @details Functional mode hands over to the pipeline at functionalUntil, between two instructions; the pipeline
+ * restarts empty at the next PC.
+ */
+template<class Controller>
+void
+Pipeline<Controller>::step(){
+    if (functional && functionalUntil > 0 && controller().getCurrentSimCycle() >= functionalUntil){
+        functional = false;
+        resetPipeline(pc);
+        CAMSHAP_VERBOSE(controller().outFile, 1, Controller::PIPELINE_MASK, "Switch to cycle-accurate pipeline at PC %5" PRIu32 "\n", pc);
+    }
+    if (functional){
+        stepFunctional();
+    }
+    else{
+        stepPipeline();
+    }
+}
+
+template<class Controller>
+float_t
+Pipeline<Controller>::convertFP8toFP32(uint8_t fp8){
+    return FPDecoder::decode(fp8, uint32_t(FPFormat::E4M3));
+}
+
+template<class Controller>
+float_t
+Pipeline<Controller>::simdMul(float_t a, float_t b){
+    float_t result = 0.0;
+    uint32_t* a32 = reinterpret_cast<uint32_t*>(&a);
+    uint32_t* b32 = reinterpret_cast<uint32_t*>(&b);
+    for (uint32_t i = 0; i < 32; i+=8){
+        uint8_t a8 = (*a32 >> i) & 0xff;
+        uint8_t b8 = (*b32 >> i) & 0xff;
+        float_t a8_fp = convertFP8toFP32(a8);
+        float_t b8_fp = convertFP8toFP32(b8);
+        result += a8_fp * b8_fp;
+    }
+    return result;
+}
+
+template<class Controller>
+float_t
+Pipeline<Controller>::convertINTtoFP32(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth){
+    uint32_t value = (fourth << 24) + (third << 16) + (second << 8) + (first);
+    float_t* fp = reinterpret_cast<float_t*>(&value);
+    return *fp;
+}
+
+}
+}
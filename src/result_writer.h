@@ -0,0 +1,145 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace SST {
+namespace CAMSHAP {
+
+/**
+* @brief Buffered writer of SHAP results as full-precision binary records, with an optional CSV mirror
+* @details The file starts with the 8-byte magic "CAMSHAP\0" and a uint32 version. Each record is, little-endian:
+* uint32 sample id, uint32 class, uint64 completion time (ns), uint32 number of values, then the FP32 values.
+* Records are appended to an in-memory buffer and written out only when it is full or on close. The CSV mirror has one
+* row per record: sample, class, time_ns, then one shap column per value, all comma-separated.
+*/
+class ResultWriter {
+public:
+    static const uint32_t VERSION = 1;
+
+    ResultWriter() : file(nullptr), csv(nullptr), csvHeader(false), capacity(0) { }
+    ~ResultWriter() { close(); }
+
+    /** Open 'path' (and 'csvPath' unless empty). Returns false if a file cannot be opened. */
+    bool open(const std::string &path, std::size_t bufferSize, const std::string &csvPath) {
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if (!file){
+            return false;
+        }
+        if (!csvPath.empty()){
+            csv = std::fopen(csvPath.c_str(), "w");
+            if (!csv){
+                return false;
+            }
+            csvHeader = false;
+        }
+        capacity = bufferSize;
+        buffer.reserve(capacity);
+        uint32_t version = VERSION;
+        append("CAMSHAP", 8);
+        append(&version, 4);
+        return true;
+    }
+
+    void write(uint32_t sampleId, uint32_t classId, uint64_t timeNs, const float *value, uint32_t numValue) {
+        std::size_t recordSize = 20 + 4 * std::size_t(numValue);
+        if (buffer.size() + recordSize > capacity){
+            flush();
+        }
+        append(&sampleId, 4);
+        append(&classId, 4);
+        append(&timeNs, 8);
+        append(&numValue, 4);
+        append(value, 4 * std::size_t(numValue));
+        if (csv){
+            // The number of shap columns is only known with the first record
+            if (!csvHeader){
+                csvBuffer += "sample,class,time_ns";
+                for (uint32_t i = 0; i < numValue; i++){
+                    csvBuffer += ",shap" + std::to_string(i);
+                }
+                csvBuffer += '\n';
+                csvHeader = true;
+            }
+            csvBuffer += std::to_string(sampleId) + "," + std::to_string(classId) + "," + std::to_string(timeNs);
+            for (uint32_t i = 0; i < numValue; i++){
+                // %.9g round-trips every FP32 value and fits the buffer
+                char field[32];
+                std::snprintf(field, sizeof(field), ",%.9g", value[i]);
+                csvBuffer += field;
+            }
+            csvBuffer += '\n';
+            if (csvBuffer.size() > capacity){
+                flush();
+            }
+        }
+    }
+
+    void flush() {
+        if (file && !buffer.empty()){
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+            buffer.clear();
+        }
+        if (csv && !csvBuffer.empty()){
+            std::fwrite(csvBuffer.data(), 1, csvBuffer.size(), csv);
+            csvBuffer.clear();
+        }
+    }
+
+    void close() {
+        flush();
+        if (file){
+            std::fclose(file);
+            file = nullptr;
+        }
+        if (csv){
+            std::fclose(csv);
+            csv = nullptr;
+        }
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+private:
+    void append(const void *data, std::size_t size) {
+        const char *byte = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), byte, byte + size);
+    }
+
+    std::FILE                       *file;
+    std::FILE                       *csv;
+    std::vector<char>               buffer;
+    std::string                     csvBuffer;
+    bool                            csvHeader;
+    std::size_t                     capacity;
+};
+
+}
+}
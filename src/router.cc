@@ -1,193 +1,381 @@
-// MIT License
-//
-// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-//		
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
-// 
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
-
-#include "router.h"
-
-using namespace SST;
-using namespace SST::CAMSHAP;
-
-/**
-* @brief Main constructor for router
-* @details Read parameters, configure output, register clock handler, and configure links.
-*/
-router::router(ComponentId_t id, Params &params) : Component(id) {
-    
-    /* Read parameters */
-    uint32_t verbose        = params.find<uint32_t>("verbose", 0);
-    uint32_t mask           = params.find<uint32_t>("mask", 0);
-    std::string name        = params.find<std::string>("name");
-    UnitAlgebra freq        = params.find<UnitAlgebra>("freq", "1GHz");
-    latency                 = params.find<uint32_t>("latency", 1);
-    numPort                 = params.find<uint32_t>("numPort", 1);
-
-    /* Configure output (outStd: command prompt, outFile: txt file) */
-    std::string outputDir   = params.find<std::string>("outputDir");
-    std::string prefix = "@t ["+name+"]:";
-    outStd.init(prefix, verbose, mask, Output::STDOUT);
-    outFile.init("@t ", verbose, mask, Output::FILE, outputDir+name+".txt");
-
-    /* Register clock handler */ 
-    clockHandler    = new Clock::Handler<router>(this, &router::clockTick);
-    clockPeriod     = registerClock(freq, clockHandler);
-
-    /* Configure links */
-    fromUpLink      = configureLink("fromUpPort", new Event::Handler<router>(this, &router::handleUp));
-    toUpLink        = configureLink("toUpPort");
-
-    for (uint32_t i = 0; i < numPort; ++i){
-        fromDownPort.push_back(new Port(i, clockPeriod, this));
-        fromDownLink.push_back(configureLink("fromDownPort"+std::to_string(i), new Event::Handler<Port>(fromDownPort.back(), &Port::handleDown)));
-
-        toDownLink.push_back(configureLink("toDownPort"+std::to_string(i)));
-    }
-    dataLink        = configureSelfLink("data", freq, new Event::Handler<router>(this, &router::handleData));
-    resultLink      = configureSelfLink("result", freq, new Event::Handler<router>(this, &router::handleResult));
-
-    /* Register statistics */
-    activeCycleFPU  = registerStatistic<uint32_t>("activeCycleFPU");
-    activeCycleMUX  = registerStatistic<uint32_t>("activeCycleMUX");
-}
-
-void
-router::handleUp(Event *ev) {
-    CAMSHAPEvent *dataEv = static_cast<CAMSHAPEvent*>(ev);
-    fromUpQueue.push(getNextClockCycle(clockPeriod), 0, dataEv);
-}
-
-void
-router::Port::handleDown(Event *ev) {
-    CAMSHAPEvent *resultEv = static_cast<CAMSHAPEvent*>(ev);
-    portQueue.push(m_router->getNextClockCycle(clockPeriod), 0, resultEv);
-}
-
-void
-router::handleResult(Event *ev) {
-    CAMSHAPEvent *resultEv = static_cast<CAMSHAPEvent*>(ev);
-    std::vector<uint8_t> result = resultEv->getPayload();
-    uint32_t size = result.size();
-    float_t sum = 0.0;
-    for (uint32_t i = 0 ; i < size; i=i+4){
-        outFile.verbose(CALL_INFO, 1, (1<<2), "%10s - %5s %5s %5s %5s = %.5f\n", "Input result", std::to_string(result[i+3]).c_str(), std::to_string(result[i+2]).c_str(), std::to_string(result[i+1]).c_str(), std::to_string(result[i]).c_str(), convertINTtoFP32(result[i], result[i+1], result[i+2], result[i+3]));
-        sum += convertINTtoFP32(result[i], result[i+1], result[i+2], result[i+3]);
-        activeCycleFPU->addData(1);
-    }
-    uint32_t sumFP32 = convertFP32toINT(sum);
-    std::vector<uint8_t> sumResult(4,0);
-    sumResult[3] = (sumFP32 >> 24) & 0xff;
-    sumResult[2] = (sumFP32 >> 16) & 0xff;
-    sumResult[1] = (sumFP32 >> 8) & 0xff;
-    sumResult[0] = sumFP32 & 0xff;
-    outFile.verbose(CALL_INFO, 1, (1<<2), "%10s - %5s %5s %5s %5s = %.5f\n", "Sum Result", std::to_string(sumResult[3]).c_str(), std::to_string(sumResult[2]).c_str(), std::to_string(sumResult[1]).c_str(), std::to_string(sumResult[0]).c_str(), sum);
-    CAMSHAPEvent *sumEv = new CAMSHAPEvent(resultEv->getOpcode(), resultEv->getDst(), resultEv->getSrc1(), resultEv->getSrc2(), resultEv->getImm(), sumResult);
-    toUpLink->send(sumEv);
-    busy_result = false;
-    delete ev;
-}
-
-void
-router::handleData(Event *ev) {
-    CAMSHAPEvent *dataEv = static_cast<CAMSHAPEvent*>(ev);
-    for (uint32_t i = 0; i < numPort; ++i){
-        CAMSHAPEvent *dataEvClone = dataEv->clone();
-        toDownLink[i]->send(dataEvClone);
-        activeCycleMUX->addData(1);
-    }
-    outFile.verbose(CALL_INFO, 1, (1<<2), "%10s - %5s %5s %5s %5s\n", "Data", std::to_string(dataEv->getPayload()[3]).c_str(), std::to_string(dataEv->getPayload()[2]).c_str(), std::to_string(dataEv->getPayload()[1]).c_str(), std::to_string(dataEv->getPayload()[0]).c_str());
-    busy_data = false;
-    delete ev;
-}
-
-bool
-router::clockTick(Cycle_t cycle) {
-
-    if (!busy_result){
-        uint32_t opcode, dst, src1, src2;
-        uint32_t imm = UINT32_MAX;
-        bool anyIn = false;
-        std::vector<uint8_t> resultMat;
-        for (uint32_t i = 0; i < 2*numPort; ++i){
-            CAMSHAPEvent *fromEv = static_cast<CAMSHAPEvent*>(fromDownPort[i/2]->getEvent(cycle));
-            if (fromEv){
-                busy_result = true;
-                anyIn = true;
-                if (imm == fromEv->getImm()){
-                    resultMat.push_back(fromEv->getPayload()[0]);
-                    resultMat.push_back(fromEv->getPayload()[1]);
-                    resultMat.push_back(fromEv->getPayload()[2]);
-                    resultMat.push_back(fromEv->getPayload()[3]);
-                }
-                else if (imm == UINT32_MAX){
-                    opcode = fromEv->getOpcode();
-                    src1 = fromEv->getSrc1();
-                    src2 = fromEv->getSrc2();
-                    imm = fromEv->getImm();
-                    dst = fromEv->getDst();
-                    resultMat.push_back(fromEv->getPayload()[0]);
-                    resultMat.push_back(fromEv->getPayload()[1]);
-                    resultMat.push_back(fromEv->getPayload()[2]);
-                    resultMat.push_back(fromEv->getPayload()[3]);
-                }
-                else{
-                    CAMSHAPEvent *resultMatEv = new CAMSHAPEvent(opcode, dst, src1, src2, imm, resultMat);
-                    resultLink->send(latency-1, resultMatEv);
-                    opcode = fromEv->getOpcode();
-                    src1 = fromEv->getSrc1();
-                    src2 = fromEv->getSrc2();
-                    imm = fromEv->getImm();
-                    dst = fromEv->getDst();
-                    resultMat.clear();
-                    resultMat.push_back(fromEv->getPayload()[0]);
-                    resultMat.push_back(fromEv->getPayload()[1]);
-                    resultMat.push_back(fromEv->getPayload()[2]);
-                    resultMat.push_back(fromEv->getPayload()[3]);
-                }
-                delete fromEv;
-            }
-        }
-        if (anyIn){
-            CAMSHAPEvent *resultMatEv = new CAMSHAPEvent(opcode, dst, src1, src2, imm, resultMat);
-            resultLink->send(latency-1, resultMatEv);
-        }
-    }
-
-    if (!busy_data){
-        CAMSHAPEvent *dataEv = static_cast<CAMSHAPEvent*>(fromUpQueue.pop(cycle));
-        if (dataEv){
-            busy_data = true;
-            dataLink->send(latency-1, dataEv);
-        }
-    }
-    return false; 
-}
-
-float_t
-router::convertINTtoFP32(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth){
-    uint32_t value = (fourth << 24) + (third << 16) + (second << 8) + (first);
-    float_t* fp = reinterpret_cast<float_t*>(&value);
-    return *fp;
-}
-
-uint32_t
-router::convertFP32toINT(float_t value){
-    uint32_t* fp32 = reinterpret_cast<uint32_t*>(&value);
-    return *fp32;
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "router.h"
+
+using namespace SST;
+using namespace SST::CAMSHAP;
+
+/**
+* @brief Main constructor for router
+* @details Read parameters, configure output, register clock handler, and configure links.
+*/
+router::router(ComponentId_t id, Params &params) : Component(id) {
+    
+    /* Read parameters */
+    uint32_t verbose        = params.find<uint32_t>("verbose", 0);
+    uint32_t mask           = params.find<uint32_t>("mask", 0);
+    std::string name        = params.find<std::string>("name");
+    UnitAlgebra freq        = params.find<UnitAlgebra>("freq", "1GHz");
+    latency                 = params.find<uint32_t>("latency", 1);
+    numPort                 = params.find<uint32_t>("numPort", 1);
+    firstTile               = params.find<uint32_t>("firstTile", 0);
+    tilePerPort             = params.find<uint32_t>("tilePerPort", 1);
+    uint32_t queueCapacity  = params.find<uint32_t>("queueCapacity", 0);
+    bool upRouter           = params.find<bool>("upRouter", false);
+    bool downRouter         = params.find<bool>("downRouter", false);
+
+    /* Every router takes the same queueCapacity, so a router starts with one credit per entry of its peer's queue */
+    upCredit                = (upRouter && queueCapacity > 0) ? queueCapacity : UINT32_MAX;
+    downCredit.assign(numPort, (downRouter && queueCapacity > 0) ? queueCapacity : UINT32_MAX);
+
+    /* Configure output (outStd: command prompt, outFile: txt file) */
+    std::string outputDir   = params.find<std::string>("outputDir");
+    std::string prefix = "@t ["+name+"]:";
+    outStd.init(prefix, verbose, mask, Output::STDOUT);
+    outFile.init("@t ", verbose, mask, Output::FILE, outputDir+name+".txt");
+
+    /* Register clock handler */ 
+    clockHandler    = new Clock::Handler<router>(this, &router::clockTick);
+    clockPeriod     = registerClock(freq, clockHandler);
+
+    /* Configure links */
+    fromUpLink      = configureLink("fromUpPort", new Event::Handler<router>(this, &router::handleUp));
+    toUpLink        = configureLink("toUpPort");
+
+    for (uint32_t i = 0; i < numPort; ++i){
+        fromDownPort.push_back(new Port(i, queueCapacity, clockPeriod, this));
+        fromDownLink.push_back(configureLink("fromDownPort"+std::to_string(i), new Event::Handler<Port>(fromDownPort.back(), &Port::handleDown)));
+
+        toDownLink.push_back(configureLink("toDownPort"+std::to_string(i)));
+    }
+    dataLink        = configureSelfLink("data", freq, new Event::Handler<router>(this, &router::handleData));
+    resultLink      = configureSelfLink("result", freq, new Event::Handler<router>(this, &router::handleResult));
+    tracer.configure(params, outputDir+name+".trace.json", name, getId(), getTimeConverter("1us"));
+
+    /* Register statistics */
+    activeCycleFPU  = registerStatistic<uint32_t>("activeCycleFPU");
+    activeCycleMUX  = registerStatistic<uint32_t>("activeCycleMUX");
+    bytesFromUp     = registerStatistic<uint64_t>("bytesFromUp");
+    bytesToUp       = registerStatistic<uint64_t>("bytesToUp");
+    for (uint32_t i = 0; i < numPort; ++i){
+        bytesFromDown.push_back(registerStatistic<uint64_t>("bytesFromDown", std::to_string(i)));
+        bytesToDown.push_back(registerStatistic<uint64_t>("bytesToDown", std::to_string(i)));
+    }
+    creditStallUp   = registerStatistic<uint64_t>("creditStall", "up");
+    creditStallDown = registerStatistic<uint64_t>("creditStall", "down");
+    fromUpQueue = Queue<Event*>(queueCapacity);
+    registerQueueStatistics(fromUpQueue, "up");
+    for (uint32_t i = 0; i < numPort; ++i){
+        registerQueueStatistics(fromDownPort[i]->getQueue(), std::to_string(i));
+    }
+}
+
+/**
+ * @brief Register the statistics of an input queue under subId 'port'.
+ */
+void
+router::registerQueueStatistics(Queue<Event*> &queue, const std::string &port){
+    queue.setStatistics(registerStatistic<uint32_t>("queueDepth", port),
+                        registerStatistic<uint64_t>("queueWait", port),
+                        registerStatistic<uint64_t>("queueOverflow", port));
+    queueMaxDepth.push_back(registerStatistic<uint32_t>("queueMaxDepth", port));
+}
+
+/**
+ * @brief Record the largest depth of each input queue (up first, then the down ports) and dump the trace.
+ */
+void
+router::finish(){
+    queueMaxDepth[0]->addData(fromUpQueue.getMaxDepth());
+    for (uint32_t i = 0; i < numPort; ++i){
+        queueMaxDepth[i+1]->addData(fromDownPort[i]->getQueue().getMaxDepth());
+    }
+    tracer.dump();
+}
+
+/**
+ * @brief Handle event from upper level.
+ * @details A credit from the upper router frees an entry of its port queue for the results of this router.
+ */
+void
+router::handleUp(Event *ev) {
+    CAMSHAPEvent *dataEv = static_cast<CAMSHAPEvent*>(ev);
+    if (dataEv->getOpcode() == CREDIT){
+        ++upCredit;
+        delete dataEv;
+        wakeClock();
+        return;
+    }
+    if (upCredit != UINT32_MAX && fromUpQueue.full()){
+        outFile.fatal(CALL_INFO, -1, "Upper router sent data without a credit\n");
+    }
+    if (bytesFromUp->isEnabled()){
+        bytesFromUp->addData(dataEv->getWireSize());
+    }
+    if (dataEv->getTraceId() != Tracer::UNTRACED){
+        traceBegin.push_back(getCurrentSimCycle());
+    }
+    wakeClock();
+    fromUpQueue.push(getNextClockCycle(clockPeriod), 0, dataEv);
+}
+
+/**
+ * @brief Handle event from a down port.
+ * @details A credit from the router below frees an entry of its queue for the data of this router.
+ */
+void
+router::Port::handleDown(Event *ev) {
+    CAMSHAPEvent *resultEv = static_cast<CAMSHAPEvent*>(ev);
+    if (resultEv->getOpcode() == CREDIT){
+        ++m_router->downCredit[portID];
+        delete resultEv;
+        m_router->wakeClock();
+        return;
+    }
+    if (m_router->downCredit[portID] != UINT32_MAX && portQueue.full()){
+        m_router->outFile.fatal(CALL_INFO, -1, "Router on port %" PRIu32 " sent a result without a credit\n", portID);
+    }
+    if (m_router->bytesFromDown[portID]->isEnabled()){
+        m_router->bytesFromDown[portID]->addData(resultEv->getWireSize());
+    }
+    m_router->wakeClock();
+    portQueue.push(m_router->getNextClockCycle(clockPeriod), 0, resultEv);
+}
+
+/**
+ * @brief Handle result event.
+ * @details Sum the FP32 results in the payload and forward the same event upward with the sum as its payload.
+ */
+void
+router::handleResult(Event *ev) {
+    CAMSHAPEvent *resultEv = static_cast<CAMSHAPEvent*>(ev);
+    Payload &result = resultEv->getPayload();
+    uint32_t size = result.size();
+    float_t sum = 0.0;
+    for (uint32_t i = 0 ; i < size; i=i+4){
+        CAMSHAP_VERBOSE(outFile, 1, (1<<2), "%10s - %5s %5s %5s %5s = %.5f\n", "Input result", std::to_string(result[i+3]).c_str(), std::to_string(result[i+2]).c_str(), std::to_string(result[i+1]).c_str(), std::to_string(result[i]).c_str(), convertINTtoFP32(result[i], result[i+1], result[i+2], result[i+3]));
+        sum += convertINTtoFP32(result[i], result[i+1], result[i+2], result[i+3]);
+        activeCycleFPU->addData(1);
+    }
+    uint32_t sumFP32 = convertFP32toINT(sum);
+    result.assign(4, 0);
+    result[3] = (sumFP32 >> 24) & 0xff;
+    result[2] = (sumFP32 >> 16) & 0xff;
+    result[1] = (sumFP32 >> 8) & 0xff;
+    result[0] = sumFP32 & 0xff;
+    CAMSHAP_VERBOSE(outFile, 1, (1<<2), "%10s - %5s %5s %5s %5s = %.5f\n", "Sum Result", std::to_string(result[3]).c_str(), std::to_string(result[2]).c_str(), std::to_string(result[1]).c_str(), std::to_string(result[0]).c_str(), sum);
+    if (bytesToUp->isEnabled()){
+        bytesToUp->addData(resultEv->getWireSize());
+    }
+    if (resultEv->getTraceId() != Tracer::UNTRACED){
+        tracer.span("reduce", resultEv->getTraceId(), traceReduce.front(), getCurrentSimCycle());
+        traceReduce.pop_front();
+    }
+    toUpLink->send(resultEv);
+    busy_result = false;
+}
+
+/**
+ * @brief Handle data event.
+ * @details Multicast data event to the down ports whose tiles overlap the destination tile range of the event.
+ * The last of those ports gets the original event, the others get clones.
+ */
+void
+router::handleData(Event *ev) {
+    CAMSHAPEvent *dataEv = static_cast<CAMSHAPEvent*>(ev);
+    uint32_t traceId = dataEv->getTraceId();
+    CAMSHAP_VERBOSE(outFile, 1, (1<<2), "%10s - %5s %5s %5s %5s\n", "Data", std::to_string(dataEv->getPayload()[3]).c_str(), std::to_string(dataEv->getPayload()[2]).c_str(), std::to_string(dataEv->getPayload()[1]).c_str(), std::to_string(dataEv->getPayload()[0]).c_str());
+    uint32_t lastPort = numPort;
+    for (uint32_t i = 0; i < numPort; ++i){
+        uint32_t portFirst = firstTile + i*tilePerPort;
+        if (!dataEv->isForTile(portFirst, portFirst + tilePerPort - 1)){
+            continue;
+        }
+        if (bytesToDown[i]->isEnabled()){
+            bytesToDown[i]->addData(dataEv->getWireSize());
+        }
+        if (lastPort < numPort){
+            toDownLink[lastPort]->send(dataEv->clone());
+            activeCycleMUX->addData(1);
+        }
+        lastPort = i;
+    }
+    if (lastPort < numPort){
+        toDownLink[lastPort]->send(dataEv);
+        activeCycleMUX->addData(1);
+    }
+    else{
+        delete dataEv;
+    }
+    if (traceId != Tracer::UNTRACED){
+        tracer.span("broadcast", traceId, traceBegin.front(), getCurrentSimCycle());
+        traceBegin.pop_front();
+    }
+    busy_data = false;
+}
+
+bool
+router::clockTick(Cycle_t cycle) {
+
+    if (!busy_result){
+        uint32_t opcode, dst, src1, src2;
+        uint32_t imm = UINT32_MAX;
+        uint32_t traceId = Tracer::UNTRACED;
+        bool anyIn = false;
+        Payload resultMat;
+        for (uint32_t i = 0; i < 2*numPort; ++i){
+            CAMSHAPEvent *fromEv = static_cast<CAMSHAPEvent*>(fromDownPort[i/2]->peekEvent(cycle));
+            // Each result sent up takes a credit: stop before a result that would need one more than is left
+            if (fromEv && (upCredit == 0 || (imm != UINT32_MAX && imm != fromEv->getImm() && upCredit < 2))){
+                creditStallUp->addData(1);
+                break;
+            }
+            if (fromEv){
+                fromDownPort[i/2]->getEvent(cycle);
+                if (downCredit[i/2] != UINT32_MAX){
+                    returnCredit(toDownLink[i/2]);
+                }
+                busy_result = true;
+                anyIn = true;
+                Payload &fromPayload = fromEv->getPayload();
+                if (imm == fromEv->getImm()){
+                    resultMat.append(fromPayload.begin(), fromPayload.begin()+4);
+                    traceId = std::min(traceId, fromEv->getTraceId()); // UNTRACED is the largest id
+                }
+                else if (imm == UINT32_MAX){
+                    opcode = fromEv->getOpcode();
+                    src1 = fromEv->getSrc1();
+                    src2 = fromEv->getSrc2();
+                    imm = fromEv->getImm();
+                    dst = fromEv->getDst();
+                    traceId = fromEv->getTraceId();
+                    resultMat.reserve(8*numPort);
+                    resultMat.append(fromPayload.begin(), fromPayload.begin()+4);
+                }
+                else{
+                    sendResult(new CAMSHAPEvent(opcode, dst, src1, src2, imm, std::move(resultMat)), traceId);
+                    opcode = fromEv->getOpcode();
+                    src1 = fromEv->getSrc1();
+                    src2 = fromEv->getSrc2();
+                    imm = fromEv->getImm();
+                    dst = fromEv->getDst();
+                    traceId = fromEv->getTraceId();
+                    resultMat.reserve(8*numPort);
+                    resultMat.append(fromPayload.begin(), fromPayload.begin()+4);
+                }
+                delete fromEv;
+            }
+        }
+        if (anyIn){
+            sendResult(new CAMSHAPEvent(opcode, dst, src1, src2, imm, std::move(resultMat)), traceId);
+        }
+    }
+
+    if (!busy_data){
+        CAMSHAPEvent *dataEv = static_cast<CAMSHAPEvent*>(fromUpQueue.front(cycle));
+        if (dataEv && !takeDownCredit(dataEv)){
+            creditStallDown->addData(1);
+        }
+        else if (dataEv){
+            fromUpQueue.pop(cycle);
+            if (upCredit != UINT32_MAX){
+                returnCredit(toUpLink);
+            }
+            busy_data = true;
+            dataLink->send(latency-1, dataEv);
+        }
+    }
+    // Nothing queued on any port: stop ticking until the next event arrives
+    clockIdle = fromUpQueue.empty();
+    for (uint32_t i = 0; i < numPort && clockIdle; ++i){
+        clockIdle = fromDownPort[i]->isEmpty();
+    }
+    return clockIdle;
+}
+
+/**
+ * @brief Send the results gathered from the down ports to handleResult, tagged with the traced sample among them.
+ */
+void
+router::sendResult(CAMSHAPEvent *resultEv, uint32_t traceId){
+    if (traceId != Tracer::UNTRACED){
+        traceReduce.push_back(getCurrentSimCycle());
+    }
+    if (upCredit != UINT32_MAX){
+        --upCredit;
+    }
+    resultLink->send(latency-1, resultEv->setTraceId(traceId));
+}
+
+/**
+ * @brief Reserve an entry in the queue of every router below that the data event goes to.
+ * @details Nothing is reserved unless all of them have room, so the event waits at the head of fromUpQueue.
+ */
+bool
+router::takeDownCredit(CAMSHAPEvent *dataEv){
+    for (uint32_t i = 0; i < numPort; ++i){
+        uint32_t portFirst = firstTile + i*tilePerPort;
+        if (downCredit[i] == 0 && dataEv->isForTile(portFirst, portFirst + tilePerPort - 1)){
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < numPort; ++i){
+        uint32_t portFirst = firstTile + i*tilePerPort;
+        if (downCredit[i] != UINT32_MAX && dataEv->isForTile(portFirst, portFirst + tilePerPort - 1)){
+            --downCredit[i];
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Give the router on 'link' back the entry of this router's queue that was just popped.
+ */
+void
+router::returnCredit(Link *link){
+    link->send(new CAMSHAPEvent(CREDIT, 0, 0, 0, 0, Payload()));
+}
+
+/**
+ * @brief Re-register the clock if it was suspended because the unit ran out of work.
+ */
+void
+router::wakeClock(){
+    if (clockIdle){
+        reregisterClock(clockPeriod, clockHandler);
+        clockIdle = false;
+    }
+}
+
+float_t
+router::convertINTtoFP32(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth){
+    uint32_t value = (fourth << 24) + (third << 16) + (second << 8) + (first);
+    float_t* fp = reinterpret_cast<float_t*>(&value);
+    return *fp;
+}
+
+uint32_t
+router::convertFP32toINT(float_t value){
+    uint32_t* fp32 = reinterpret_cast<uint32_t*>(&value);
+    return *fp32;
 }
\ No newline at end of file
@@ -1,162 +1,208 @@
-// MIT License
-//
-// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-//		
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
-// 
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
-
-#ifndef _ROUTER_COMPONENT_H
-#define _ROUTER_COMPONENT_H
-
-#include "event.h"
-#include "data_queue.h"
-
-#include <sst/core/component.h>
-#include <sst/core/link.h>
-#include <sst/core/timeConverter.h>
-#include <sst/core/timeLord.h>
-#include <sst/core/output.h>
-#include <sst/core/unitAlgebra.h>
-
-#include <iostream>
-#include <vector>
-#include <cmath>
-
-namespace SST {
-namespace CAMSHAP {
-/**
-* @brief Router
-* @details 
-*/
-class router : public SST::Component {
-public:
-    /**
-    * @brief Register a component.
-    * @details SST_ELI_REGISTER_COMPONENT(class, “library”, “name”, version, “description”, category).
-    */
-    SST_ELI_REGISTER_COMPONENT(
-        router,
-        "camshap",
-        "router",
-        SST_ELI_ELEMENT_VERSION(1,0,0),
-        "Router",
-        COMPONENT_CATEGORY_UNCATEGORIZED
-    );
-    /**
-    * @brief List of parameters
-    * @details SST_ELI_DOCUMENT_PARAMS({ “name”, “description”, “default value” }).
-    */
-    SST_ELI_DOCUMENT_PARAMS(
-        {"verbose",             "(uint) Output verbosity. The higher verbosity, the more debug info", "0"},
-        {"mask",                "(uint) Output mask", "0"},
-        {"name",                "(string) Name of component"},
-        {"freq",                "(UnitAlgebra) Clock frequency", "1GHz"},
-        {"latency",             "(uint) Latency of component operation (handleSelf)", "1"},
-        {"numPort",             "(uint) Number of ports", "1"},
-        {"outputDir",           "(string) Path of output files", " "},
-    );
-    /**
-    * @brief List of ports
-    * @details SST_ELI_DOCUMENT_PORTS({ “name”, “description”, vector of supported events }).
-    */
-    SST_ELI_DOCUMENT_PORTS(
-        {"fromUpPort",          "Port from upper level",    {"camshap.CAMSHAPEvent"}},
-        {"toUpPort",            "Port to upper level",      {"camshap.CAMSHAPEvent"}},
-        {"fromDownPort%d",      "Port from lower level",    {"camshap.CAMSHAPEvent"}},
-        {"toDownPort%d",        "Port to lower level",      {"camshap.CAMSHAPEvent"}},
-    );
-    /**
-    * @brief List of statistics
-    * @details SST_ELI_DOCUMENT_STATISTICS({ “name”, “description”, “units”, enable level }).
-    */
-    SST_ELI_DOCUMENT_STATISTICS(
-        { "activeCycleFPU",     "Active cycles of FPU", "cycles", 1},
-        { "activeCycleMUX",     "Active cycles of MUX", "cycles", 1},
-    );
-    SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
-    );
-    router(ComponentId_t id, Params& params);
-    ~router() { }
-
-    void handleUp( SST::Event* ev );
-    void handleResult( SST::Event* ev );
-    void handleData( SST::Event* ev );
-    bool clockTick( Cycle_t cycle );
-    float_t convertINTtoFP32(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth);
-    uint32_t convertFP32toINT(float_t value);
-
-    void init( unsigned int phase ) {}
-	void setup() { }
-    void finish() { }
-
-private:
-    class Port {
-    public:
-        Port(uint32_t portID, TimeConverter *clockPeriod, router *router):
-            portID(portID),
-            clockPeriod(clockPeriod),
-            m_router(router)
-        {}
-
-        void handleDown( SST::Event* ev );
-        Event* getEvent(Cycle_t curCycle){ return portQueue.pop(curCycle); }
-    private:
-        uint32_t                    portID;
-        Queue<Event*>               portQueue;
-        TimeConverter               *clockPeriod;
-        router                      *m_router;
-    };
-
-    /** Clock *****************************************************************/
-    Clock::Handler<router>          *clockHandler;
-    TimeConverter                   *clockPeriod;
-
-    /** IO ********************************************************************/
-    Output                          outStd;
-    Output                          outFile;
-
-    /** Link/Port *************************************************************/
-    Link*                           fromUpLink;
-    Link*                           toUpLink;
-    Link*                           dataLink;
-    Link*                           resultLink;
-    std::vector<Link*>              fromDownLink;
-    std::vector<Link*>              toDownLink;
-    std::vector<Port*>              fromDownPort;
-
-    /** Temporary data/result *************************************************/
-    Queue<Event*>                   fromUpQueue;
-
-    /** Parameters ************************************************************/
-    uint32_t                        latency;
-    uint32_t                        numPort;
-
-
-    /** Control signal ********************************************************/
-    bool                            busy_data = false;
-    bool                            busy_result = false;
-    
-    /** Statistics ************************************************************/
-    Statistic<uint32_t>*            activeCycleFPU;
-    Statistic<uint32_t>*            activeCycleMUX;
-};
-
-}
-}
-
-#endif
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _ROUTER_COMPONENT_H
+#define _ROUTER_COMPONENT_H
+
+#include "event.h"
+#include "data_queue.h"
+#include "verbose.h"
+
+#include <sst/core/component.h>
+#include <sst/core/link.h>
+#include <sst/core/timeConverter.h>
+#include <sst/core/timeLord.h>
+#include <sst/core/output.h>
+#include <sst/core/unitAlgebra.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <cmath>
+
+namespace SST {
+namespace CAMSHAP {
+/**
+* @brief Router
+* @details 
+*/
+class router : public SST::Component {
+public:
+    /**
+    * @brief Register a component.
+    * @details SST_ELI_REGISTER_COMPONENT(class, “library”, “name”, version, “description”, category).
+    */
+    SST_ELI_REGISTER_COMPONENT(
+        router,
+        "camshap",
+        "router",
+        SST_ELI_ELEMENT_VERSION(1,0,0),
+        "Router",
+        COMPONENT_CATEGORY_UNCATEGORIZED
+    );
+    /**
+    * @brief List of parameters
+    * @details SST_ELI_DOCUMENT_PARAMS({ “name”, “description”, “default value” }).
+    */
+    SST_ELI_DOCUMENT_PARAMS(
+        {"verbose",             "(uint) Output verbosity. The higher verbosity, the more debug info", "0"},
+        {"mask",                "(uint) Output mask", "0"},
+        {"name",                "(string) Name of component"},
+        {"freq",                "(UnitAlgebra) Clock frequency", "1GHz"},
+        {"latency",             "(uint) Latency of component operation (handleSelf)", "1"},
+        {"numPort",             "(uint) Number of ports", "1"},
+        {"firstTile",           "(uint) Index of the first tile under this router", "0"},
+        {"tilePerPort",         "(uint) Number of tiles under each down port", "1"},
+        {"queueCapacity",       "(uint) Entries of each input queue (from upper level and from each down port). Routers hold events back until the next router has room; arrivals from a control unit beyond it count as queueOverflow. 0: unbounded", "0"},
+        {"upRouter",            "(bool) The upper level is a router, which is given a credit for each event taken from fromUpPort", "false"},
+        {"downRouter",          "(bool) The lower level is made of routers, which are given a credit for each event taken from their port", "false"},
+        {"traceBuffer",         "(uint) Spans kept by the tracer, the oldest are overwritten", "65536"},
+        {"outputDir",           "(string) Path of output files", " "},
+    );
+    /**
+    * @brief List of ports
+    * @details SST_ELI_DOCUMENT_PORTS({ “name”, “description”, vector of supported events }).
+    */
+    SST_ELI_DOCUMENT_PORTS(
+        {"fromUpPort",          "Port from upper level",    {"camshap.CAMSHAPEvent"}},
+        {"toUpPort",            "Port to upper level",      {"camshap.CAMSHAPEvent"}},
+        {"fromDownPort%d",      "Port from lower level",    {"camshap.CAMSHAPEvent"}},
+        {"toDownPort%d",        "Port to lower level",      {"camshap.CAMSHAPEvent"}},
+    );
+    /**
+    * @brief List of statistics
+    * @details SST_ELI_DOCUMENT_STATISTICS({ “name”, “description”, “units”, enable level }).
+    */
+    SST_ELI_DOCUMENT_STATISTICS(
+        { "activeCycleFPU",     "Active cycles of FPU", "cycles", 1},
+        { "activeCycleMUX",     "Active cycles of MUX", "cycles", 1},
+        { "bytesFromUp",        "Serialized bytes of events received from upper level", "bytes", 2},
+        { "bytesToUp",          "Serialized bytes of events sent to upper level", "bytes", 2},
+        { "bytesFromDown",      "Serialized bytes of events received from lower level (subId: port)", "bytes", 2},
+        { "bytesToDown",        "Serialized bytes of events sent to lower level (subId: port)", "bytes", 2},
+        { "queueDepth",         "Depth of an input queue seen by each arriving event (subId: up or port)", "events", 2},
+        { "queueMaxDepth",      "Largest depth of an input queue, recorded at finish (subId: up or port)", "events", 2},
+        { "queueWait",          "Cycles each event waited in an input queue (subId: up or port)", "cycles", 2},
+        { "queueOverflow",      "Events that arrived while an input queue was full (subId: up or port)", "events", 2},
+        { "creditStall",        "Cycles a ready event was held back because the next router had no room (subId: up or down)", "cycles", 2},
+    );
+    SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
+    );
+    router(ComponentId_t id, Params& params);
+    ~router() { }
+
+    void handleUp( SST::Event* ev );
+    void handleResult( SST::Event* ev );
+    void handleData( SST::Event* ev );
+    bool clockTick( Cycle_t cycle );
+    void wakeClock();
+    void registerQueueStatistics(Queue<Event*> &queue, const std::string &port);
+    void sendResult(CAMSHAPEvent *resultEv, uint32_t traceId);
+    bool takeDownCredit(CAMSHAPEvent *dataEv);
+    void returnCredit(Link *link);
+    float_t convertINTtoFP32(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth);
+    uint32_t convertFP32toINT(float_t value);
+
+    void init( unsigned int phase ) {}
+	void setup() { }
+    void finish();
+
+    /** Opcode of the event that gives a queue entry back to the router that filled it */
+    static const uint32_t CREDIT = 255;
+
+private:
+    class Port {
+    public:
+        Port(uint32_t portID, uint32_t capacity, TimeConverter *clockPeriod, router *router):
+            portID(portID),
+            portQueue(capacity),
+            clockPeriod(clockPeriod),
+            m_router(router)
+        {}
+
+        void handleDown( SST::Event* ev );
+        Event* getEvent(Cycle_t curCycle){ return portQueue.pop(curCycle); }
+        Event* peekEvent(Cycle_t curCycle) const { return portQueue.front(curCycle); }
+        bool isEmpty() const { return portQueue.empty(); }
+        Queue<Event*>& getQueue() { return portQueue; }
+    private:
+        uint32_t                    portID;
+        Queue<Event*>               portQueue;
+        TimeConverter               *clockPeriod;
+        router                      *m_router;
+    };
+
+    /** Clock *****************************************************************/
+    Clock::Handler<router>          *clockHandler;
+    TimeConverter                   *clockPeriod;
+
+    /** IO ********************************************************************/
+    Output                          outStd;
+    Output                          outFile;
+    Tracer                          tracer;
+
+    /** Link/Port *************************************************************/
+    Link*                           fromUpLink;
+    Link*                           toUpLink;
+    Link*                           dataLink;
+    Link*                           resultLink;
+    std::vector<Link*>              fromDownLink;
+    std::vector<Link*>              toDownLink;
+    std::vector<Port*>              fromDownPort;
+
+    /** Temporary data/result *************************************************/
+    Queue<Event*>                   fromUpQueue;
+    std::deque<SimTime_t>           traceBegin;
+    std::deque<SimTime_t>           traceReduce;
+
+    /** Parameters ************************************************************/
+    uint32_t                        latency;
+    uint32_t                        numPort;
+    uint32_t                        firstTile;
+    uint32_t                        tilePerPort;
+
+    /** Flow control (UINT32_MAX: the peer is not a router and is never held back) */
+    uint32_t                        upCredit;
+    std::vector<uint32_t>           downCredit;
+
+    /** Control signal ********************************************************/
+    bool                            busy_data = false;
+    bool                            busy_result = false;
+    bool                            clockIdle = false;
+    
+    /** Statistics ************************************************************/
+    Statistic<uint32_t>*            activeCycleFPU;
+    Statistic<uint32_t>*            activeCycleMUX;
+    Statistic<uint64_t>*            bytesFromUp;
+    Statistic<uint64_t>*            bytesToUp;
+    std::vector<Statistic<uint64_t>*> bytesFromDown;
+    std::vector<Statistic<uint64_t>*> bytesToDown;
+    std::vector<Statistic<uint32_t>*> queueMaxDepth;
+    Statistic<uint64_t>*            creditStallUp;
+    Statistic<uint64_t>*            creditStallDown;
+};
+
+}
+}
+
+#endif
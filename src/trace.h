@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <sst/core/params.h>
+#include <sst/core/timeConverter.h>
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace SST {
+namespace CAMSHAP {
+
+/**
+* @brief Per-component recorder of the spans spent on traced test samples, dumped as a Chrome/Perfetto trace
+* @details control_node tags one test sample out of every traceEvery with its sample id, on the COPY that issues it
+* (funct3=2) and the class COPYs after it. Every event derived from them carries the id down to the accelerators and
+* back. Untagged events cost a single compare. Spans are kept, in core time, in a ring of traceBuffer fixed-size records
+* that overwrites its oldest span when full, and are only formatted at finish, to <outputDir><name>.trace.json. plot.mergeTrace() joins the files of all components into one trace.
+*/
+class Tracer {
+public:
+    static const uint32_t UNTRACED = UINT32_MAX;
+
+    Tracer() : usTime(nullptr), capacity(0), numSpan(0), tid(0) { }
+
+    void configure(Params &params, const std::string &_path, const std::string &_name, uint64_t _tid, TimeConverter *_usTime) {
+        capacity    = params.find<uint32_t>("traceBuffer", 65536);
+        path        = _path;
+        name        = _name;
+        tid         = _tid;
+        usTime      = _usTime;
+    }
+
+    /** Record [begin, end] (core time) of 'sampleId', unless it is untraced */
+    void span(const char *spanName, uint32_t sampleId, SimTime_t begin, SimTime_t end) {
+        if (sampleId == UNTRACED || capacity == 0){
+            return;
+        }
+        if (ring.empty()){
+            ring.resize(capacity);
+        }
+        Span &s     = ring[numSpan % capacity];
+        s.begin     = begin;
+        s.end       = end;
+        s.sampleId  = sampleId;
+        s.name      = nameIndex(spanName);
+        numSpan++;
+    }
+
+    /** Write the recorded spans as trace JSON. Nothing is written if no sample was traced. */
+    void dump() {
+        if (numSpan == 0){
+            return;
+        }
+        std::FILE *file = std::fopen(path.c_str(), "w");
+        if (!file){
+            return;
+        }
+        double usFactor = usTime ? double(usTime->getFactor()) : 1e6;
+        uint64_t first = numSpan > capacity ? numSpan - capacity : 0;
+        std::fprintf(file, "{\"traceEvents\":[\n");
+        std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%" PRIu64 ",\"args\":{\"name\":\"%s\"}}", tid, name.c_str());
+        for (uint64_t i = first; i < numSpan; i++){
+            const Span &s = ring[i % capacity];
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"camshap\",\"ph\":\"X\",\"pid\":0,\"tid\":%" PRIu64 ",\"ts\":%.6f,\"dur\":%.6f,\"args\":{\"sample\":%" PRIu32 "}}",
+                names[s.name], tid, double(s.begin) / usFactor, double(s.end - s.begin) / usFactor, s.sampleId);
+        }
+        std::fprintf(file, "\n],\"otherData\":{\"dropped\":%" PRIu64 "}}\n", first);
+        std::fclose(file);
+    }
+
+private:
+    /** 24 bytes per span: the name is an index into 'names' */
+    struct Span {
+        SimTime_t   begin;
+        SimTime_t   end;
+        uint32_t    sampleId;
+        uint16_t    name;
+    };
+
+    /** Span names are string literals, so a few pointer compares find them */
+    uint16_t nameIndex(const char *spanName) {
+        for (uint16_t i = 0; i < names.size(); i++){
+            if (names[i] == spanName){
+                return i;
+            }
+        }
+        names.push_back(spanName);
+        return names.size() - 1;
+    }
+
+    std::string                     path;
+    std::string                     name;
+    TimeConverter                   *usTime;
+    std::vector<Span>               ring;
+    std::vector<const char*>        names;
+    uint32_t                        capacity;
+    uint64_t                        numSpan;
+    uint64_t                        tid;
+};
+
+}
+}
@@ -0,0 +1,46 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//		
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <sst/core/output.h>
+
+/**
+* @brief Highest verbose level compiled in
+* @details Set with ./configure --with-max-verbose=LEVEL. By default every level is kept.
+*/
+#ifndef CAMSHAP_MAX_VERBOSE
+#define CAMSHAP_MAX_VERBOSE 4
+#endif
+
+/**
+* @brief Output::verbose() that only evaluates its arguments when the message is printed
+* @details Same level and mask test as Output::verbose(), done before the arguments (register dumps, std::to_string
+* temporaries) are built. A level above CAMSHAP_MAX_VERBOSE is a constant false test, so the call is compiled out.
+*/
+#define CAMSHAP_VERBOSE(out, level, mask, ...) \
+    do { \
+        if ((level) <= CAMSHAP_MAX_VERBOSE && (level) <= (out).getVerboseLevel() && ((mask) & ~(out).getVerboseMask()) == 0){ \
+            (out).verbose(CALL_INFO, (level), (mask), __VA_ARGS__); \
+        } \
+    } while (0)
@@ -0,0 +1,117 @@
+// MIT License
+//
+// Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "payload.h"
+
+namespace SST {
+namespace CAMSHAP {
+
+/**
+* @brief Compact byte encoding of event fields for links crossing MPI ranks.
+* @details Integers are LEB128 varints. A payload made of 4-byte words (FP32 results) is packed by dropping zero words
+* behind a presence bitmap when that is smaller than the raw bytes; other payloads are copied as is.
+*/
+class WireCodec {
+public:
+    static void putVarint(std::vector<uint8_t> &wire, uint32_t value) {
+        while (value >= 0x80){
+            wire.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        wire.push_back(static_cast<uint8_t>(value));
+    }
+
+    static uint32_t getVarint(const std::vector<uint8_t> &wire, std::size_t &pos) {
+        uint32_t value = 0;
+        for (uint32_t shift = 0; pos < wire.size() && shift < 35; shift += 7){
+            uint8_t byte = wire[pos++];
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)){
+                break;
+            }
+        }
+        return value;
+    }
+
+    /** Payload header is varint(size << 1 | packed) */
+    static void putPayload(std::vector<uint8_t> &wire, const Payload &payload) {
+        uint32_t size = payload.size();
+        uint32_t numWord = size / 4;
+        uint32_t numNonZero = 0;
+        if (size % 4 == 0){
+            for (uint32_t w = 0; w < numWord; ++w){
+                numNonZero += !isZeroWord(payload.data() + 4*w);
+            }
+        }
+        bool packed = (size % 4 == 0) && (numWord > 0) && ((numWord + 7)/8 + 4*numNonZero < size);
+        putVarint(wire, (size << 1) | (packed ? 1 : 0));
+        if (!packed){
+            wire.insert(wire.end(), payload.begin(), payload.end());
+            return;
+        }
+        std::size_t bitmap = wire.size();
+        wire.resize(bitmap + (numWord + 7)/8, 0);
+        for (uint32_t w = 0; w < numWord; ++w){
+            const uint8_t *word = payload.data() + 4*w;
+            if (!isZeroWord(word)){
+                wire[bitmap + w/8] |= (1 << (w%8));
+                wire.insert(wire.end(), word, word + 4);
+            }
+        }
+    }
+
+    static void getPayload(const std::vector<uint8_t> &wire, std::size_t &pos, Payload &payload) {
+        uint32_t header = getVarint(wire, pos);
+        uint32_t size = header >> 1;
+        if (!(header & 1)){
+            payload.assign(wire.begin() + pos, wire.begin() + pos + size);
+            pos += size;
+            return;
+        }
+        uint32_t numWord = size / 4;
+        std::size_t bitmap = pos;
+        pos += (numWord + 7)/8;
+        payload.assign(size, 0);
+        for (uint32_t w = 0; w < numWord; ++w){
+            if (wire[bitmap + w/8] & (1 << (w%8))){
+                std::memcpy(payload.data() + 4*w, &wire[pos], 4);
+                pos += 4;
+            }
+        }
+    }
+
+private:
+    static bool isZeroWord(const uint8_t *word) {
+        return (word[0] | word[1] | word[2] | word[3]) == 0;
+    }
+};
+
+}
+}
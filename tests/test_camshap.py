@@ -1,57 +1,64 @@
-# MIT License
-
-# Copyright (c) 2024 Hewlett Packard Enterprise Development LP
-		
-# Permission is hereby granted, free of charge, to any person obtaining a copy
-# of this software and associated documentation files (the "Software"), to deal
-# in the Software without restriction, including without limitation the rights
-# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-# copies of the Software, and to permit persons to whom the Software is
-# furnished to do so, subject to the following conditions:
-
-# The above copyright notice and this permission notice shall be included in all
-# copies or substantial portions of the Software.
-
-# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-# SOFTWARE.
-
-from util import *
-from noc import *
-from configure import *
-
-if __name__ == "__main__":
-
-    arg = readArg()
-
-    inputConfig = sstConfig(arg['idx'], arg['folder'])
-    print("Model configuration ... \n")
-    mConfig = modelConfig(arg, inputConfig.sw.getConfig())
-    mConfig_dict = mConfig.getConfig(overwrite=True)
-
-    partConfig = {}
-    print("aCAM configuration ... \n")
-    aConfig = acamConfig(inputConfig.hw.getConfig(), inputConfig.sw.getConfig(), mConfig_dict)
-    partConfig['acam'], tilePerClass = aConfig.getConfig()
-
-    print("Node configuration ... \n")
-    nConfig = nodeConfig(inputConfig.sw.getConfig(), mConfig_dict)
-    partConfig['node'] = nConfig.getConfig()
-
-    print("Tile configuration ... \n")
-    tConfig = tileConfig(inputConfig.hw.getConfig(), inputConfig.sw.getConfig(), mConfig_dict, tilePerClass)
-    partConfig['tile'] = tConfig.getConfig()
-
-    print("Core configuration ... \n")
-    cConfig = coreConfig(inputConfig.hw.getConfig(), inputConfig.sw.getConfig(), partConfig['acam']['acamValue'])
-    partConfig['core'] = cConfig.getConfig()
-
-    print("SST configuration ... \n")
-    nocConfig = configureNode(inputConfig.hw.getConfig(), inputConfig.sw.getConfig(), partConfig)
-    sstNode = node(nocConfig['node'])
-    sstNode.build()
-    setStatistic(2, inputConfig.sw.getConfig()["logDir"], [])
\ No newline at end of file
+# MIT License
+
+# Copyright (c) 2024 Hewlett Packard Enterprise Development LP
+		
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+from util import *
+from configure import *
+
+if __name__ == "__main__":
+
+    arg = readArg()
+
+    # Regression, after a simulation of the default configuration:
+    # python3 ./tests/test_camshap.py --folder=FOLDER --baseline=./tests/baseline/churn_xgboost_tree800_depth10_trial0.txt
+    if arg['baseline']:
+        sys.exit(1 if compareResult("./log/{0}/{1:d}/".format(arg['folder'], arg['idx']), arg['baseline'], arg['tolerance']) else 0)
+
+    # Only sst provides the sst module that noc builds the components with
+    from noc import *
+
+    inputConfig = sstConfig(arg['idx'], arg['folder'])
+    print("Model configuration ... \n")
+    mConfig = modelConfig(arg, inputConfig.sw.getConfig())
+    mConfig_dict = mConfig.getConfig(overwrite=True)
+
+    partConfig = {}
+    print("aCAM configuration ... \n")
+    aConfig = acamConfig(inputConfig.hw.getConfig(), inputConfig.sw.getConfig(), mConfig_dict)
+    partConfig['acam'], tilePerClass = aConfig.getConfig()
+
+    print("Node configuration ... \n")
+    nConfig = nodeConfig(inputConfig.sw.getConfig(), mConfig_dict)
+    partConfig['node'] = nConfig.getConfig()
+
+    print("Tile configuration ... \n")
+    tConfig = tileConfig(inputConfig.hw.getConfig(), inputConfig.sw.getConfig(), mConfig_dict, tilePerClass)
+    partConfig['tile'] = tConfig.getConfig()
+
+    print("Core configuration ... \n")
+    cConfig = coreConfig(inputConfig.hw.getConfig(), inputConfig.sw.getConfig(), partConfig['acam']['acamValue'], mConfig_dict['weight'], mConfig_dict.get('fpFormat', 'E4M3'))
+    partConfig['core'] = cConfig.getConfig()
+
+    print("SST configuration ... \n")
+    nocConfig = configureNode(inputConfig.hw.getConfig(), inputConfig.sw.getConfig(), partConfig)
+    sstNode = node(nocConfig['node'])
+    sstNode.build()
+    setStatistic(2, inputConfig.sw.getConfig()["logDir"], [], inputConfig.sw.getConfig().get("latencyHistogram", {}), inputConfig.sw.getConfig().get("queueHistogram", {}))
\ No newline at end of file
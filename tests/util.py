@@ -25,11 +25,73 @@ import argparse
 import json
 import sys
 import os
+import stat
 import struct
 import pickle
 import math
 import copy
 
+# Formats of the value/weight tables: OP_V format code (funct7) and bytes per element
+FP_FORMAT = {'E4M3': 0, 'FP16': 1, 'E5M2': 2, 'BF16': 3}
+FP_WIDTH = {'E4M3': 1, 'FP16': 2, 'E5M2': 1, 'BF16': 2}
+
+def memorySize(memoryMap, minSize):
+    # Smallest data memory holding minSize bytes and every region of memoryMap
+    return max([minSize] + [base + size for base, size in memoryMap.values()])
+
+class assembler():
+    """!
+    @brief      Builder of controller programs, one row [opcode, rd, rs1, rs2, imm, funct3, funct7] per instruction.
+    @details    Branches and LOOP name a label, resolved by getInstruction. A branch at pc jumps to pc+2+offset, with
+                the sign in bit 11 of imm and the magnitude in bits 7:0. LOOP repeats the instructions up to the label
+                R[rs1] times; the body must not take a branch.
+    """
+    def __init__(self):
+        self.row = []
+        self.label = {}
+        self.target = {}
+
+    def mark(self, name):
+        self.label[name] = len(self.row)
+
+    def emit(self, opcode, rd=0, rs1=0, rs2=0, imm=0, funct3=0, funct7=0):
+        self.row.append([opcode, rd, rs1, rs2, imm, funct3, funct7])
+
+    def nop(self, count=1):
+        for i in range(count):
+            self.emit(19)
+
+    def li(self, rd, value):
+        # LUI for the upper 20 bits, then ADDI for the lower 12 when they are set
+        if value >> 12:
+            self.emit(55, rd, imm=value >> 12)
+            if value & 0xfff:
+                self.emit(19, rd, rd, imm=value & 0xfff)
+        else:
+            self.emit(19, rd, imm=value)
+
+    def branch(self, funct3, rs1, rs2, label):
+        self.target[len(self.row)] = label
+        self.emit(99, 0, rs1, rs2, 0, funct3)
+
+    def loop(self, rs1, label):
+        self.target[len(self.row)] = label
+        self.emit(91, 0, rs1)
+
+    def getInstruction(self):
+        instruction = []
+        for pc, row in enumerate(self.row):
+            if pc in self.target and row[0] == 91:
+                row = row[:4] + [self.label[self.target[pc]] - pc - 1] + row[5:]
+            elif pc in self.target:
+                offset = self.label[self.target[pc]] - (pc + 2)
+                if abs(offset) > 0xff:
+                    sys.exit(f"FATAL: branch at {pc} to {self.target[pc]} is out of range ({offset})")
+                row = row[:4] + [offset if offset >= 0 else 2048 - offset] + row[5:]
+            instruction += row
+        return instruction
+
+
 class nodeConfig():
     def __init__(self, param, model):
         self.numTest = param['numTest']
@@ -40,82 +102,97 @@ class nodeConfig():
         self.offsetPartialSHAP = param['offsetPartialSHAP']
         self.offsetSHAP = param['offsetSHAP']
         self.offsetNodeSample = param['offsetNodeSample']
+        self.sampleStream = param.get('sampleStream', '')
+        self.memoryMap = param['memoryMap']['node']
     
         self.model = model
 
     def getInstruction(self):
-        instruction = [ 55,	10,	0,	0,	6,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        3,	11,	10,	0,	16,	2,	0,\
-                        3,	12,	10,	0,	20,	3,	0,\
-                        3,	13,	10,	0,	24,	2,	0,\
-                        3,	15,	10,	0,	8,	2,	0,\
-                        3,	22,	10,	0,	12,	2,	0,\
-                        3,	14,	10,	0,	0,	2,	0,\
-                        7,	1,	10,	0,	4,	2,	0,\
-                        51,	16,	22,	15,	0,	0,	1,\
-                        11,	0,	13,	15,	0,	1,	0,\
-                        3,	21,	10,	0,	28,	2,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        99,	0,	21,	0,	2053,	0,	0,\
-                        19,	23,	0,	0,	0,	0,	0,\
-                        35, 0,  10, 0, 28, 2,  0,\
-                        7,	2,	11,	0,	0,	2,	0,\
-                        7,	3,	12,	0,	0,	2,	0,\
-                        19,	19,	19,	0,	1,	0,	0,\
-                        19,	23,	23,	0,	1,	0,	0,\
-                        83,	4,	2,	1,	0,	0,	12,\
-                        19,	11,	11,	0,	4,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        83,	3,	3,	4,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        39,	0,	12,	3,	0,	2,	0,\
-                        19,	12,	12,	0,	4,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        99,	0,	23,	22,	2063,	1,	0,\
-                        99,	0,	19,	16,	2070,	1,	0,\
-                        19, 18, 18, 0,  1,  0,  0,\
-                        19, 19, 0,  0,  0,  0,  0,\
-                        3,  11, 10, 0,  16, 2,  0,\
-                        3,	12,	10,	0,	20,	2,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        99, 0,  18, 14, 2076,   1,  0,\
-                        19,	20,	16,	0,	2,	1,	0,\
-                        51,	13,	13,	15,	0,	0,	0,\
-                        19,	17,	17,	0,	1,	0,	0,\
-                        19,	19,	0,	0,	0,	0,	0,\
-                        19, 18, 0,  0,  0,  0,  0,\
-                        11,	0,	12,	20,	0,	0,	0,\
-                        39,	0,	12,	0,	0,	2,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        99,	0,	17,	14,	2086,	1,	0,\
-                        0,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        ]
-        return instruction
+        # Parameter block: numTest, numBase, numFeature, numClass, offsetPartialSHAP, offsetSHAP, offsetNodeSample
+        # SHAP holds one record of numFeature values per class: r26 walks the features, r12 the classes of one
+        resultFlag = self.memoryMap['resultFlag'][0]
+        p = assembler()
+        p.li(10, self.memoryMap['param'][0])
+        p.emit(3, 11, 10, imm=16, funct3=2)
+        p.emit(3, 26, 10, imm=20, funct3=2)
+        p.emit(3, 13, 10, imm=24, funct3=2)
+        p.emit(3, 15, 10, imm=8, funct3=2)
+        p.emit(3, 22, 10, imm=12, funct3=2)
+        p.emit(3, 14, 10, imm=0, funct3=2)
+        p.emit(7, 1, 10, imm=4, funct3=2)
+        p.emit(51, 16, 22, 15, funct7=1)
+        p.emit(19, 24, 15, imm=2, funct3=1)
+        # Send and issue a test sample (funct3=2), then accumulate partial/numBase into SHAP as the tile results arrive
+        p.mark('sample')
+        p.emit(11, 0, 13, 15, funct3=2)
+        p.mark('result')
+        p.emit(3, 21, 0, imm=resultFlag, funct3=2)
+        p.branch(0, 21, 0, 'result')
+        p.emit(35, 0, 0, imm=resultFlag, funct3=2)
+        p.emit(19, 12, 26)
+        p.loop(22, 'classEnd')
+        p.emit(7, 2, 11, funct3=2)
+        p.emit(7, 3, 12, funct3=2)
+        p.emit(83, 4, 2, 1, funct7=12)
+        p.emit(19, 11, 11, imm=4)
+        p.emit(83, 3, 3, 4)
+        p.emit(39, 0, 12, 3, funct3=2)
+        p.emit(51, 12, 12, 24)
+        p.mark('classEnd')
+        p.emit(19, 26, 26, imm=4)
+        p.emit(51, 19, 19, 22)
+        p.branch(1, 19, 16, 'result')
+        p.emit(19, 18, 18, imm=1)
+        p.emit(19, 19)
+        p.emit(3, 11, 10, imm=16, funct3=2)
+        p.emit(3, 26, 10, imm=20, funct3=2)
+        p.branch(1, 18, 14, 'result')
+        if not self.sampleStream:
+            # A streamed sample is refilled in place, so r13 stays on the input region
+            p.emit(51, 13, 13, 15)
+        p.emit(19, 17, 17, imm=1)
+        p.emit(19, 18)
+        # Write one result record per class, with the class index in rd; the node clears each record once written
+        p.emit(19, 12, 26)
+        p.emit(19, 27)
+        p.loop(22, 'writeEnd')
+        p.emit(11, 27, 12, 24)
+        p.emit(19, 27, 27, imm=1)
+        p.emit(51, 12, 12, 24)
+        p.mark('writeEnd')
+        p.branch(1, 17, 14, 'sample')
+        p.emit(0)
+        return p.getInstruction()
 
     def getData(self):
-        data = np.zeros(32768, dtype=np.uint8)
-        data[24576] = self.numTest
-        data[24580:24580+4] = list(struct.pack('<f', self.numBase))
-        data[24584] = self.numFeature
-        data[24588] = self.numClass
-        data[24592:24592+4] = list(self.offsetPartialSHAP.to_bytes(4, byteorder='little'))
-        data[24596:24596+4] = list(self.offsetSHAP.to_bytes(4, byteorder='little'))
-        data[24600:24600+4] = list(self.offsetNodeSample.to_bytes(4, byteorder='little'))
-        data[self.offsetNodeSample:self.offsetNodeSample + self.numTest*self.numFeature] = self.model['testSample'].flatten()
+        param = self.memoryMap['param'][0]
+        data = np.zeros(memorySize(self.memoryMap, 32768), dtype=np.uint8)
+        data[param] = self.numTest
+        data[param+4:param+8] = list(struct.pack('<f', self.numBase))
+        data[param+8] = self.numFeature
+        data[param+12] = self.numClass
+        data[param+16:param+20] = list(self.offsetPartialSHAP.to_bytes(4, byteorder='little'))
+        data[param+20:param+24] = list(self.offsetSHAP.to_bytes(4, byteorder='little'))
+        data[param+24:param+28] = list(self.offsetNodeSample.to_bytes(4, byteorder='little'))
+        if not self.sampleStream:
+            data[self.offsetNodeSample:self.offsetNodeSample + self.numTest*self.numFeature] = self.model['testSample'].flatten()
         return data.tolist()
 
+    def writeSampleStream(self):
+        """!
+        @brief      Write the test samples to sampleStream, numFeature bytes each.
+        @details    A named pipe is left to its own writer, so that samples can be produced while the simulation runs.
+        """
+        if not self.sampleStream or (os.path.exists(self.sampleStream) and stat.S_ISFIFO(os.stat(self.sampleStream).st_mode)):
+            return
+        with open(self.sampleStream, 'wb') as f:
+            f.write(self.model['testSample'][:self.numTest].astype(np.uint8).tobytes())
+
     def getConfig(self):
         config  = {}
         config['instruction'] = self.getInstruction()
         config['data'] = self.getData()
+        self.writeSampleStream()
         return config
 
 class tileConfig():
@@ -125,61 +202,54 @@ class tileConfig():
         self.numFeature = param['numFeature']
         self.numBase = param['numBase']
         
-        self.offsetTileSample = param['offsetTileSample']
         self.offsetTileBase = param['offsetTileBase']
-        self.offsetTileResult = param['offsetTileResult']
+        self.memoryMap = param['memoryMap']['tile']
 
         self.base = model['baseSample']
 
     def getInstruction(self):
-        instruction = [ 55,	10,	0,	0,	4,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	10,	10,	0,	128,	0,	0,\
-                        19,	16,	0,	0,	4,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        3,	11,	10,	0,	8,	2,	0,\
-                        3,	12,	10,	0,	12,	2,	0,\
-                        3,	13,	10,	0,	20,	2,	0,\
-                        3,	14,	10,	0,	0,	2,	0,\
-                        3,	15,	10,	0,	4,	2,	0,\
-                        3,	21,	10,	0,	24,	2,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        99,	0,	21,	0,	2053,	0,	0,\
-                        35,	0,	10,	0,	24,	2,	0,\
-                        11,	0,	11,	15,	0,	1,	0,\
-                        11,	0,	12,	15,	0,	1,	0,\
-                        3,	22,	10,	0,	28,	2,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        99,	0,	22,	0,	2053,	0,	0,\
-                        35,	0,	10,	0,	28,	2,	0,\
-                        11,	0,	13,	16,	0,	0,	0,\
-                        19,	18,	18,	0,	1,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        99,	0,	18,	15,	2059,	1,	0,\
-                        51,	12,	12,	15,	0,	0,	0,\
-                        19,	17,	17,	0,	1,	0,	0,\
-                        19,	18,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        99,	0,	17,	14,	2065,	1,	0,\
-                        3,	12,	10,	0,	12,	2,	0,\
-                        19,	17,	0,	0,	0,	0,	0,\
-                        19,	18,	0,	0,	0,	0,	0,\
-                        19,	0,	0,	0,	0,	0,	0,\
-                        99,	0,	0,	0,	2076,	0,	0,
-                        ]
-        return instruction
+        # Parameter block: numBase, numFeature, offsetTileBase
+        routerFlag = self.memoryMap['routerFlag'][0]
+        coreFlag = self.memoryMap['coreFlag'][0]
+        p = assembler()
+        p.li(10, self.memoryMap['param'][0])
+        p.emit(19, 16, imm=4)
+        p.li(11, self.memoryMap['sample'][0])
+        p.emit(3, 12, 10, imm=8, funct3=2)
+        p.li(13, self.memoryMap['sum'][0])
+        p.emit(3, 14, 10, imm=0, funct3=2)
+        p.emit(3, 15, 10, imm=4, funct3=2)
+        # Multicast the test sample and every base sample, forwarding the core sum of each feature
+        p.mark('sample')
+        p.emit(3, 21, 0, imm=routerFlag, funct3=2)
+        p.branch(0, 21, 0, 'sample')
+        p.emit(35, 0, 0, imm=routerFlag, funct3=2)
+        p.emit(11, 0, 11, 15, funct3=1)
+        p.mark('base')
+        p.emit(11, 0, 12, 15, funct3=1)
+        p.mark('feature')
+        p.emit(3, 22, 0, imm=coreFlag, funct3=2)
+        p.branch(0, 22, 0, 'feature')
+        p.emit(35, 0, 0, imm=coreFlag, funct3=2)
+        p.emit(11, 0, 13, 16)
+        p.emit(19, 18, 18, imm=1)
+        p.branch(1, 18, 15, 'feature')
+        p.emit(51, 12, 12, 15)
+        p.emit(19, 17, 17, imm=1)
+        p.emit(19, 18)
+        p.branch(1, 17, 14, 'base')
+        p.emit(3, 12, 10, imm=8, funct3=2)
+        p.emit(19, 17)
+        p.emit(19, 18)
+        p.branch(0, 0, 0, 'sample')
+        return p.getInstruction()
 
     def getData(self):
-        data = np.zeros(17408, dtype=np.uint8)
-        data[16512] = self.numBase
-        data[16516] = self.numFeature
-        data[16520:16520+4] = list(self.offsetTileSample.to_bytes(4, byteorder='little'))
-        data[16524:16524+4] = list(self.offsetTileBase.to_bytes(4, byteorder='little'))
-        data[16532:16532+4] = list(self.offsetTileResult.to_bytes(4, byteorder='little'))
+        param = self.memoryMap['param'][0]
+        data = np.zeros(memorySize(self.memoryMap, 17408), dtype=np.uint8)
+        data[param] = self.numBase
+        data[param+4] = self.numFeature
+        data[param+8:param+12] = list(self.offsetTileBase.to_bytes(4, byteorder='little'))
         data[self.offsetTileBase:self.offsetTileBase + self.numBase*self.numFeature] = self.base.flatten()
         return data.tolist()
 
@@ -191,212 +261,133 @@ class tileConfig():
         return config
 
 class coreConfig():
-    def __init__(self, hwConfig, param, leafValue):
+    def __init__(self, hwConfig, param, leafValue, weight, fpFormat='E4M3'):
         self.numTile = pow(hwConfig['node']['numPort'], hwConfig['node']['numLevel'])
         self.numCore = hwConfig['node']['numCore']
+        self.numRow = hwConfig['node']['numRow']
 
         self.numBase = param['numBase']
         self.numFeature = param['numFeature']
         
         self.offsetCAM = param['offsetCAM']
-        self.offsetCoreSample = param['offsetCoreSample']
-        self.offsetCoreBase = param['offsetCoreBase']
         self.offsetValue = param['offsetValue']
         self.offsetWeight = param['offsetWeight']
+        self.memoryMap = param['memoryMap']['core']
 
         self.leafValue = leafValue
-        self.wValue = np.array([ 0, 0,  0,  0,  0,  0,  0,  0,  0, 56,  0,  0,  0,  0,  0,  0,  0, 48,\
-                            48,  0,  0,  0,  0,  0,  0, 42, 34, 42,  0,  0,  0,  0,  0, 40, 26,\
-                            26, 40,  0,  0,  0,  0, 36, 20, 16, 20, 36,  0,  0,  0, 34, 16,  8,\
-                            8, 16, 34,  0,  0, 33, 12,  4,  3,  4, 12, 33,  0], dtype=np.uint8)
-        
+        # Weight of (n, s) at 8*n+s+1: the positive path gathers at ns, the negative one at ns+1
+        self.wValue = np.concatenate(([0], weight))
+        self.fpFormat = fpFormat
+        self.formatCode = FP_FORMAT[fpFormat]
+        self.width = FP_WIDTH[fpFormat]
+        if self.offsetValue + self.width*self.numRow > self.offsetWeight:
+            sys.exit(f"FATAL: {self.numRow} {fpFormat} values at {self.offsetValue} overlap the weights at {self.offsetWeight}")
+
     def getInstruction(self):
-        instruction = [ 19, 10, 10, 0, 1168, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        3, 11, 10, 0, 8, 2, 0,\
-                        3, 12, 10, 0, 12, 2, 0,\
-                        3, 13, 10, 0, 16, 2, 0,\
-                        19, 14, 0, 0, 1188, 0, 0,\
-                        3, 15, 10, 0, 0, 2, 0,\
-                        3, 16, 10, 0, 4, 2, 0,\
-                        3, 23, 10, 0, 24, 2, 0,\
-                        19, 24, 0, 0, 1, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        99, 0, 23, 0, 2053, 0, 0,\
-                        3, 23, 10, 0, 24, 2, 0,\
-                        19, 26, 17, 0, 2, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        99, 0, 23, 26, 2054, 1, 0,\
-                        43, 0, 0, 0, 0, 1, 0,\
-                        43, 0, 0, 0, 0, 0, 0,\
-                        11, 11, 12, 24, 0, 2, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        43, 0, 0, 0, 1, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        43, 0, 0, 0, 1, 1, 0,\
-                        11, 11, 13, 24, 0, 2, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        43, 0, 0, 0, 1, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        43, 0, 0, 0, 2, 1, 0,\
-                        43, 0, 0, 0, 3, 1, 0,\
-                        19, 18, 18, 0, 1, 0, 0,\
-                        19, 11, 11, 0, 1, 0, 0,\
-                        19, 12, 12, 0, 1, 0, 0,\
-                        19, 13, 13, 0, 1, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        99, 0, 16, 18, 2071, 1, 0,\
-                        43, 0, 0, 0, 4, 1, 0,\
-                        19, 18, 0, 0, 0, 0, 0,\
-                        3, 11, 10, 0, 8, 2, 0,\
-                        3, 12, 10, 0, 12, 2, 0,\
-                        3, 13, 10, 0, 16, 2, 0,\
-                        43, 0, 0, 0, 0, 0, 0,\
-                        11, 11, 12, 24, 0, 2, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        43, 0, 0, 0, 1, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        43, 0, 0, 0, 1, 1, 0,\
-                        11, 11, 13, 24, 0, 2, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        43, 0, 0, 0, 1, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        43, 0, 0, 0, 2, 1, 0,\
-                        43, 0, 0, 0, 5, 1, 0,\
-                        43, 0, 0, 0, 0, 2, 0,\
-                        19, 25, 0, 0, 4, 0, 0,\
-                        3, 19, 0, 0, 1152, 2, 0,\
-                        3, 20, 0, 0, 1160, 2, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        7, 1, 19, 0, 640, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        7, 5, 20, 0, 640, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        3, 21, 19, 0, 384, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        3, 22, 20, 0, 384, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        7, 2, 21, 0, 896, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        7, 6, 22, 0, 897, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 3, 1, 2, 0, 0, 8,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 7, 5, 6, 0, 0, 8,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 4, 4, 3, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 8, 8, 7, 0, 0, 0,\
-                        3, 19, 0, 0, 1156, 2, 0,\
-                        3, 20, 0, 0, 1164, 2, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        7, 1, 19, 0, 640, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        7, 5, 20, 0, 640, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        3, 21, 19, 0, 384, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        3, 22, 20, 0, 384, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        7, 2, 21, 0, 896, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        7, 6, 22, 0, 897, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 3, 1, 2, 0, 0, 8,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 7, 5, 6, 0, 0, 8,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 4, 4, 3, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 8, 8, 7, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 4, 4, 8, 0, 0, 4,\
-                        19, 18, 18, 0, 1, 0, 0,\
-                        19, 11, 11, 0, 1, 0, 0,\
-                        39, 0, 14, 4, 0, 2, 0,\
-                        19, 12, 12, 0, 1, 0, 0,\
-                        19, 13, 13, 0, 1, 0, 0,\
-                        11, 0, 14, 25, 0, 0, 0,\
-                        83, 4, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        83, 8, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        99, 0, 16, 18, 2157, 1, 0,\
-                        19, 17, 17, 0, 1, 0, 0,\
-                        19, 18, 0, 0, 0, 0, 0,\
-                        3, 11, 10, 0, 8, 2, 0,\
-                        3, 12, 10, 0, 12, 2, 0,\
-                        3, 13, 10, 0, 16, 2, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        99, 0, 15, 17, 2197, 1, 0,\
-                        35, 23, 10, 0, 24, 2, 0,\
-                        19, 17, 0, 0, 0, 0, 0,\
-                        19, 18, 0, 0, 0, 0, 0,\
-                        3, 11, 10, 0, 8, 2, 0,\
-                        3, 12, 10, 0, 12, 2, 0,\
-                        3, 13, 10, 0, 16, 2, 0,\
-                        19, 0, 0, 0, 0, 0, 0,\
-                        99, 0, 0, 0, 2209, 0, 0
-                        ]
-        return instruction
+        # Parameter block: numBase, numFeature, offsetCAM
+        mm = self.memoryMap
+        sample = mm['sample'][0]
+        mpe = mm['mpeResponse'][0]
+        mmr = mm['mmrResponse'][0]
+        p = assembler()
+
+        def rewind():
+            # r11: CAM column, r12: test sample, r13: base sample at sampleTail
+            p.emit(3, 11, 10, imm=8, funct3=2)
+            p.li(12, sample)
+            p.emit(3, 13, 0, imm=mm['sampleRead'][0], funct3=2)
+
+        p.li(10, mm['param'][0])
+        rewind()
+        p.li(14, mm['result'][0])
+        p.emit(3, 15, 10, imm=0, funct3=2)
+        p.emit(3, 16, 10, imm=4, funct3=2)
+        p.mark('sample')
+        p.emit(3, 23, 0, imm=mm['sampleFlag'][0], funct3=2)
+        p.emit(19, 24, imm=1)
+        p.branch(0, 23, 0, 'sample')
+        p.mark('base')
+        p.emit(3, 23, 0, imm=mm['sampleHead'][0], funct3=2)
+        p.branch(0, 23, 17, 'base')
+        p.emit(43, imm=0, funct3=1)
+        # Pass 1: search the test and base values of each feature and accumulate the MPE state
+        p.loop(16, 'pass1End')
+        p.emit(43, imm=0, funct3=0)
+        p.emit(11, 11, 12, 24, funct3=2)
+        p.emit(43, imm=1, funct3=0)
+        p.emit(43, imm=1, funct3=1)
+        p.emit(11, 11, 13, 24, funct3=2)
+        p.emit(43, imm=1, funct3=0)
+        p.emit(43, imm=2, funct3=1)
+        p.emit(43, imm=3, funct3=1)
+        p.emit(19, 11, 11, imm=1)
+        p.emit(19, 12, 12, imm=1)
+        p.emit(19, 13, 13, imm=1)
+        p.mark('pass1End')
+        p.emit(43, imm=4, funct3=1)
+        rewind()
+        # Pass 2: search again, then weigh the MMR paths and send the contribution of each feature
+        p.loop(16, 'pass2End')
+        p.emit(43, imm=0, funct3=0)
+        p.emit(11, 11, 12, 24, funct3=2)
+        p.emit(43, imm=1, funct3=0)
+        p.emit(43, imm=1, funct3=1)
+        p.emit(11, 11, 13, 24, funct3=2)
+        p.emit(43, imm=1, funct3=0)
+        p.emit(43, imm=2, funct3=1)
+        p.emit(43, imm=5, funct3=1)
+        p.emit(43, imm=0, funct3=2)
+        p.emit(19, 25, imm=4)
+        p.emit(87, 1, 0, 0, mmr, 0, 0)
+        p.emit(87, 2, 0, 0, mmr + 8, 0, 0)
+        p.emit(87, 3, 0, 1, self.offsetValue, 1, self.formatCode)
+        p.emit(87, 4, 0, 2, self.offsetValue, 1, self.formatCode)
+        p.emit(87, 5, 0, 1, mpe, 1, 0)
+        p.emit(87, 6, 0, 2, mpe, 1, 0)
+        p.emit(87, 7, 0, 5, self.offsetWeight, 1, self.formatCode)
+        p.emit(87, 0, 0, 6, self.offsetWeight + self.width, 1, self.formatCode)
+        p.emit(87, 4, 3, 7, 0, 3, self.formatCode)
+        p.emit(87, 8, 4, 0, 0, 3, self.formatCode)
+        p.emit(83, 4, 4, 8, funct7=4)
+        p.emit(19, 11, 11, imm=1)
+        p.emit(39, 0, 14, 4, funct3=2)
+        p.emit(19, 12, 12, imm=1)
+        p.emit(19, 13, 13, imm=1)
+        p.emit(11, 0, 14, 25)
+        p.emit(83, 4, 0, 0)
+        p.emit(83, 8, 0, 0)
+        p.mark('pass2End')
+        # Release the ring slot, and wait for the next base sample or, after numBase of them, the next test sample
+        p.emit(19, 17, 17, imm=1)
+        p.emit(35, 0, 0, 17, mm['sampleTail'][0], 2)
+        rewind()
+        p.branch(1, 15, 17, 'base')
+        p.emit(35, 0, 0, 0, mm['sampleFlag'][0], 2)
+        p.emit(19, 17)
+        p.emit(35, 0, 0, 0, mm['sampleTail'][0], 2)
+        rewind()
+        p.branch(0, 0, 0, 'sample')
+        return p.getInstruction()
 
     def getData(self, idxTile, idxCore):
         v = self.leafValue[idxTile, idxCore, :]
 
-        data = np.zeros(2024, dtype=np.uint8)
-        data[1168] = self.numBase
-        data[1172] = self.numFeature
-        data[1176:1176+4] = list(self.offsetCAM.to_bytes(4, byteorder='little'))
-        data[1180:1180+4] = list(self.offsetCoreSample.to_bytes(4, byteorder='little'))
-        data[1184:1184+4] = list(self.offsetCoreBase.to_bytes(4, byteorder='little'))
+        param = self.memoryMap['param'][0]
+        data = np.zeros(memorySize(self.memoryMap, 2024), dtype=np.uint8)
+        data[param] = self.numBase
+        data[param+4] = self.numFeature
+        data[param+8:param+12] = list(self.offsetCAM.to_bytes(4, byteorder='little'))
+        v = self.packTable(v)
+        w = self.packTable(self.wValue)
         data[self.offsetValue:self.offsetValue + len(v)] = v
-        data[self.offsetWeight:self.offsetWeight + len(self.wValue)] = self.wValue
+        data[self.offsetWeight:self.offsetWeight + len(w)] = w
 
         return data.tolist()
 
+    def packTable(self, table):
+        # Little-endian bytes of the table codes
+        return np.asarray(table, dtype='<u2' if self.width == 2 else np.uint8).view(np.uint8)
+
     def getConfig(self):
         config  = {}
         config['instruction'] = self.getInstruction()
@@ -416,7 +407,7 @@ class modelConfig():
         self.modelName = arg['modelName']
 
         temp = np.load(f"./model/{self.dataset}/{self.modelName}.npz")
-	self.modelRaw = temp['file1']
+        self.modelRaw = temp['file1']
         self.modelRaw[:, :-3] = np.round(self.modelRaw[:, :-3], decimals=3)
         self.numFeature = int((np.shape(self.modelRaw)[1]-3)/2)
         self.numClass = int(np.max(self.modelRaw[:, -2])) + 1
@@ -432,6 +423,9 @@ class modelConfig():
 
         self.bitQuant = sw['bitQuant']
         self.valueFactor = sw['valueFactor']
+        self.fpFormat = sw.get('fpFormat', 'E4M3')
+        if self.fpFormat not in FP_FORMAT:
+            sys.exit(f"FATAL: unknown fpFormat {self.fpFormat}, expected one of {list(FP_FORMAT)}")
 
         self.noiseP = sw['noiseP']
 
@@ -482,6 +476,18 @@ class modelConfig():
         
         return fp8_int
 
+    def convertFP32toFormat(self, value, fpFormat):
+        # Code of 'value' in fpFormat, rounded to nearest even
+        if fpFormat == 'E4M3':
+            return self.convertFP32toFP8(value)
+        if fpFormat == 'FP16':
+            return int(np.float16(value).view(np.uint16))
+        if fpFormat == 'E5M2':
+            fp16 = int(np.float16(value).view(np.uint16))
+            return (fp16 + 0x7f + ((fp16 >> 8) & 0x1)) >> 8
+        fp32 = int(np.float32(value).view(np.uint32))
+        return (fp32 + 0x7fff + ((fp32 >> 16) & 0x1)) >> 16
+
     def readQuantPkl(self):
         with open(self.fileName, 'rb') as f:
             self.modelConfig = pickle.load(f)
@@ -533,13 +539,12 @@ class modelConfig():
             model_c_class = self.modelRaw[self.modelRaw[:, -2] == c]
             model_row = np.shape(model_c_class)[0]
             value_raw = np.copy(model_c_class[:, -3])
-            value_fp8_int = np.zeros(model_row)
+            value_int = np.zeros(model_row, dtype=np.uint8 if FP_WIDTH[self.fpFormat] == 1 else np.uint16)
             
             for i in range(model_row):
-                value_fp8_int[i] = self.convertFP32toFP8(self.valueFactor*value_raw[i])
+                value_int[i] = self.convertFP32toFormat(self.valueFactor*value_raw[i], self.fpFormat)
                 
-            value_fp8_int = value_fp8_int.astype(np.uint8)
-            self.modelConfig[c]['value'] = value_fp8_int
+            self.modelConfig[c]['value'] = value_int
     def quantizeInput(self):
         testQuant = np.zeros_like(self.testRaw)
         baseQuant = np.zeros_like(self.baseRaw)
@@ -552,15 +557,18 @@ class modelConfig():
         self.modelConfig['testSample'] = testQuant[self.numTestOffset:self.numTestOffset+self.numTest, :]
         self.modelConfig['baseSample'] = baseQuant[:self.numBase, :]
 
-    def quantizeWeight(self, max_depth = 8):
-        weight_fp8_int = np.zeros(max_depth*max_depth, dtype=np.uint8)
+    def quantizeWeight(self, max_depth = 8, fpFormat = None):
+        # fpFormat trades precision against the footprint of the table in each core
+        fpFormat = fpFormat if fpFormat else self.fpFormat
+        weight_int = np.zeros(max_depth*max_depth, dtype=np.uint8 if FP_WIDTH[fpFormat] == 1 else np.uint16)
         
         for n in range(max_depth):
             for s in range(n):
                 temp = math.factorial(s)*math.factorial(n-s-1)/math.factorial(n)
-                weight_fp8_int[n*8+s] = self.convertFP32toFP8(temp)
+                weight_int[n*8+s] = self.convertFP32toFormat(temp, fpFormat)
         
-        self.modelConfig['weight'] = weight_fp8_int
+        self.modelConfig['weight'] = weight_int
+        self.modelConfig['fpFormat'] = fpFormat
 
     def quantize(self):
         self.modelConfig = {}
@@ -578,6 +586,8 @@ class modelConfig():
     def getConfig(self, overwrite = False):
         self.overwrite = overwrite
         self.fileName = f"./model/{self.dataset}/{self.modelName}_quant{int(self.bitQuant)}_v{self.valueFactor}_p{self.noiseP*100}.pkl"
+        if self.fpFormat != 'E4M3':
+            self.fileName = self.fileName.replace('.pkl', f"_{self.fpFormat}.pkl")
         if not (overwrite) and (os.path.isfile(self.fileName)):
             print("Already have quantized model/input/weights.")
             self.readQuantPkl()
@@ -748,17 +758,47 @@ class sstConfig():
             self.hw = jsonConfig("hw_{}".format(self.simName), self.path)
             self.sw = jsonConfig("sw_{}".format(self.simName), self.path)
 
+def compareResult(path, baselinePath, tolerance):
+    """!
+    @brief      Compare the SHAP values of a finished simulation with a baseline.
+    @details    Both files hold one line per test sample in the text format of control_node (resultFormat=text). The
+                values are printed with 3 decimals, so tolerance covers rounding and the summation order of the routers.
+    @param[in]  path:           Folder of the simulation ('./log/FOLDER/IDX/')
+    @param[in]  baselinePath:   Path of the baseline result.txt
+    @param[in]  tolerance:      Largest difference allowed for each SHAP value
+    @return     Number of mismatching samples, or -1 when the shapes differ
+    """
+    resultPath = path + "raw/result.txt0"
+    if not os.path.isfile(resultPath):
+        resultPath = path + "raw/result.txt"
+    result = np.loadtxt(resultPath, ndmin=2)
+    baseline = np.loadtxt(baselinePath, ndmin=2)
+    if result.shape != baseline.shape:
+        print(f"FAIL: {resultPath} has {result.shape} SHAP values, {baselinePath} has {baseline.shape}")
+        return -1
+    mismatch = np.flatnonzero(np.any(np.abs(result - baseline) > tolerance, axis=1))
+    for i in mismatch[:10]:
+        print(f"Sample {i:d}: max difference {np.max(np.abs(result[i] - baseline[i])):.3f}")
+    print(f"{'FAIL' if len(mismatch) else 'PASS'}: {len(mismatch):d} of {len(result):d} samples differ from {baselinePath}")
+    return len(mismatch)
+
 def readArg():
     ap = argparse.ArgumentParser()
     ap.add_argument("--dataset", type=str, default="churn", help="Name of dataset")
     ap.add_argument("--model", type=str, default="xgboost_tree800_depth10_trial0", help="Name of tree-based ML model in ./model/DATASET/ folder")
     ap.add_argument("--folder", type=str, default="churn_f100b100_v10_p0", help="Name of simulation result folder in ./log/ folder")
+    ap.add_argument("--idx", type=int, default=0, help="Index of the simulation in ./log/FOLDER/ folder")
+    ap.add_argument("--baseline", type=str, default="", help="Compare result.txt of a finished simulation with this file instead of simulating")
+    ap.add_argument("--tolerance", type=float, default=0.002, help="Largest difference from the baseline SHAP values")
     args = ap.parse_args()
 
     arg = {}
     arg['dataset'] = args.dataset
     arg['modelName'] = args.model
     arg['folder'] = args.folder
+    arg['idx'] = args.idx
+    arg['baseline'] = args.baseline
+    arg['tolerance'] = args.tolerance
 
     return arg
 